@@ -0,0 +1,135 @@
+// ========================================
+// BENCHMARK DO LOOP
+// ========================================
+// Roda o firmware no PC e mede, para cada missão:
+// - despertares do loop() por segundo (o loop() dorme entre os prazos: cada
+//   volta é um despertar, por byte na Serial, mudança na missão ou prazo
+//   vencido). Conta o quanto ele acorda, não o quanto ele aguenta.
+// - latência do SET_MISSION até o ACK (µs de relógio) e o tempo de
+//   processamento do comando: as voltas do loop() até o ACK, sem o tempo
+//   dormindo (etapa LOOP do LoopProfiler)
+// - tempo de processamento por volta do loop() e por quadro de telemetria
+//   (etapa SERIALIZE: montagem e enquadramento; a WRITE no PC mede só o
+//   harness), tirados dos histogramas do LoopProfiler
+// - bytes de telemetria por segundo
+//
+// Uso: native_bench [segundos_por_missao] [intervalMs_da_telemetria]
+//   pio run -e native_bench && .pio/build/native_bench/program 2 20
+//
+// Os números dependem do PC: servem para comparar versões do firmware,
+// não para prever o tempo no ESP32.
+
+#include "hal/hal_native.h"
+#include "hardware_map.h"
+#include "mission_registry.h"
+#include "loop_profiler.h"
+
+#include <stdio.h>
+#include <string>
+
+// Perfilador do firmware (ninho.ino)
+extern LoopProfiler profiler;
+
+// Média de uma etapa desde o último reset do perfilador, em µs
+static double meanMicros(LoopProfiler::Stage stage) {
+    const LoopProfiler::Histogram& histogram = profiler.histogram(stage);
+    if (histogram.count == 0) return 0.0;
+    return (double)histogram.totalCycles / histogram.count / profiler.cpuMHz();
+}
+
+// Separa as respostas do firmware em linhas e contabiliza cada tipo
+struct SerialStats {
+    std::string line;
+    bool ackSeen = false;
+    unsigned long telemetryBytes = 0;
+    unsigned long totalBytes = 0;
+};
+
+static void onSerial(const uint8_t* data, size_t length, void* context) {
+    SerialStats& stats = *static_cast<SerialStats*>(context);
+    stats.totalBytes += length;
+    for (size_t i = 0; i < length; i++) {
+        stats.line += (char)data[i];
+        if (data[i] != '\n') continue;
+
+        if (stats.line.find("\"type\":\"ACK\"") != std::string::npos) {
+            stats.ackSeen = true;
+        } else if (stats.line.find("\"type\":\"TELEMETRY\"") != std::string::npos) {
+            stats.telemetryBytes += stats.line.size();
+        }
+        stats.line.clear();
+    }
+}
+
+// Mexe nas entradas como um aluno faria: aperta o botão a cada 200ms
+// e gira o potenciômetro devagar
+static void driveInputs(unsigned long now) {
+    NativeHal::setInput(PIN_BUTTON, (now / 200) % 2 == 0 ? HIGH : LOW);
+    NativeHal::setAnalog(PIN_POT, (now / 2) % 4096);
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    long telemetryInterval = argc > 2 ? atol(argv[2]) : 0;
+
+    SerialStats stats;
+    NativeHal::setSerialSink(onSerial, &stats);
+
+    setup();
+    NativeHal::feedSerial("{\"type\":\"SET_ID\",\"userId\":\"bench\"}\n");
+    if (telemetryInterval > 0) {
+        char command[96];
+        snprintf(command, sizeof(command), "{\"type\":\"SET_TELEMETRY\",\"intervalMs\":%ld}\n", telemetryInterval);
+        NativeHal::feedSerial(command);
+    }
+    // Aquecimento por tempo: sem nada a fazer, cada volta dorme
+    unsigned long warmupStart = millis();
+    while (millis() - warmupStart < 200) loop();
+
+    printf("%-24s %12s %10s %10s %10s %10s %12s\n", "missao", "wakeups/s", "ack_us", "cmd_us",
+           "loop_us", "telem_us", "telem_B/s");
+
+    for (size_t m = 0; m < MissionRegistry::COUNT; m++) {
+        const char* name = MissionRegistry::NAMES[m];
+        char command[96];
+        snprintf(command, sizeof(command), "{\"type\":\"SET_MISSION\",\"missionId\":\"%s\"}\n", name);
+
+        // Latência: da chegada do comando na Serial até o ACK sair. O
+        // processamento é a soma das voltas do loop() até lá, sem os sonos.
+        stats.ackSeen = false;
+        unsigned long ackLoops = 0;
+        profiler.reset();
+        unsigned long start = micros();
+        NativeHal::feedSerial(command);
+        while (!stats.ackSeen && ackLoops < 1000000) {
+            loop();
+            ackLoops++;
+        }
+        unsigned long ackMicros = micros() - start;
+        double commandMicros = (double)profiler.histogram(LoopProfiler::LOOP).totalCycles / profiler.cpuMHz();
+
+        // Vazão: despertares do loop() e telemetria durante a janela
+        profiler.reset();
+        unsigned long loops = 0;
+        unsigned long telemetryStart = stats.telemetryBytes;
+        unsigned long windowStart = micros();
+        unsigned long window = (unsigned long)(seconds * 1000000.0);
+        unsigned long elapsed = 0;
+        while (elapsed < window) {
+            driveInputs(millis());
+            loop();
+            loops++;
+            elapsed = micros() - windowStart;
+        }
+
+        double elapsedSeconds = elapsed / 1000000.0;
+        printf("%-24s %12.0f %10lu %10.1f %10.1f %10.1f %12.1f\n", name,
+               loops / elapsedSeconds, ackMicros, commandMicros,
+               meanMicros(LoopProfiler::LOOP), meanMicros(LoopProfiler::SERIALIZE),
+               (stats.telemetryBytes - telemetryStart) / elapsedSeconds);
+    }
+
+    // A tarefa das missões nunca termina: sai sem esperar por ela
+    fflush(stdout);
+    _Exit(0);
+}
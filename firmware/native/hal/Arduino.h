@@ -0,0 +1,195 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// ========================================
+// HAL NATIVO (Linux)
+// ========================================
+// Subconjunto da API do Arduino-ESP32 usado pelo firmware, para compilar
+// src/ninho/ no PC sem alterar setup()/loop(). O estado dos pinos, a Serial
+// e o relógio são controlados pelo harness (hal_native.h).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <functional>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+// Sem IRAM nem flash separada no PC
+#define IRAM_ATTR
+#define PROGMEM
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define digitalPinToInterrupt(p) (p)
+
+// String do Arduino sobre std::string (só o que o firmware e o ArduinoJson usam)
+class String {
+public:
+    String(const char* s = "") : value(s ? s : "") {}
+    String(const std::string& s) : value(s) {}
+    explicit String(char c) : value(1, c) {}
+    String(int v) : value(std::to_string(v)) {}
+    String(unsigned v) : value(std::to_string(v)) {}
+    String(long v) : value(std::to_string(v)) {}
+    String(unsigned long v) : value(std::to_string(v)) {}
+
+    const char* c_str() const { return value.c_str(); }
+    size_t length() const { return value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    bool reserve(unsigned size) { value.reserve(size); return true; }
+    bool concat(const char* s) { value += s; return true; }
+    bool concat(char c) { value += c; return true; }
+    long toInt() const { return atol(value.c_str()); }
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == other; }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator!=(const char* other) const { return value != other; }
+    char operator[](unsigned i) const { return value[i]; }
+
+private:
+    std::string value;
+};
+
+// O ArduinoJson detecta a String do Arduino por esse tipo
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const char* s) : String(s) {}
+};
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str(), s.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return print(String(v)); }
+    size_t print(unsigned v) { return print(String(v)); }
+    size_t print(long v) { return print(String(v)); }
+    size_t print(unsigned long v) { return print(String(v)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& v) { return print(v) + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long ms) { timeout = ms; }
+    size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    String readStringUntil(char terminator);
+
+protected:
+    int timedRead();
+    unsigned long timeout = 1000;
+};
+
+// Serial ligada ao harness: recepção por NativeHal::feedSerial() e
+// transmissão para o destino escolhido (stdout por padrão)
+class HardwareSerial : public Stream {
+public:
+    size_t setTxBufferSize(size_t size) { return size; }
+    void begin(unsigned long baud) { speed = baud; }
+    void end() {}
+    void updateBaudRate(unsigned long baud) { speed = baud; }
+    uint32_t baudRate() const { return speed; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    int availableForWrite();
+    void flush() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    operator bool() const { return true; }
+
+    // Chamado (fora da trava da Serial) a cada feedSerial()
+    void onReceive(std::function<void()> callback) { receiveCallback = callback; }
+    const std::function<void()>& receiveHandler() const { return receiveCallback; }
+
+private:
+    uint32_t speed = 0;
+    std::function<void()> receiveCallback;
+};
+
+extern HardwareSerial Serial;
+
+// Contador de ciclos de uma CPU fictícia de 1 GHz (1 ciclo = 1ns)
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 1000; }
+};
+
+extern EspClass ESP;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+uint16_t analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void ledcDetachPin(uint8_t pin);
+int8_t digitalPinToAnalogChannel(uint8_t pin);
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+void setup();
+void loop();
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef PREFERENCES_H
+#define PREFERENCES_H
+
+#include <Arduino.h>
+
+// NVS em memória: os valores duram enquanto o processo rodar
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end() {}
+
+    bool isKey(const char* key);
+    bool remove(const char* key);
+
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLength);
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+
+private:
+    std::string space;
+};
+
+#endif
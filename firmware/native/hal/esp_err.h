@@ -0,0 +1,13 @@
+#ifndef ESP_ERR_H
+#define ESP_ERR_H
+
+// Códigos de erro do ESP-IDF usados pelo firmware
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_NOT_SUPPORTED 0x106
+#define ESP_ERR_TIMEOUT 0x107
+
+#endif
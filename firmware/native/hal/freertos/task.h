@@ -0,0 +1,23 @@
+#ifndef FREERTOS_TASK_H
+#define FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+// Cada tarefa vira uma thread do sistema; núcleo e prioridade são ignorados
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+
+// Notificações diretas (contador por tarefa). Em tempo virtual ninguém
+// espera: ulTaskNotifyTake() retorna na hora.
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+
+// O loop() do Arduino-ESP32 roda no núcleo 1
+inline BaseType_t xPortGetCoreID() { return 1; }
+
+#endif
@@ -0,0 +1,621 @@
+#include "hal_native.h"
+#include <Preferences.h>
+#include <driver/adc.h>
+#include <esp_timer.h>
+#include <soc/gpio_struct.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+// ========================================
+// RELÓGIO
+// ========================================
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+static bool virtualTime = false;
+static std::atomic<uint64_t> virtualMicros(0);
+
+static uint64_t now64() {
+    if (virtualTime) return virtualMicros;
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(now64() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)now64();
+}
+
+// Em tempo virtual, esperar é só adiantar o relógio
+static void wait(uint64_t us) {
+    if (virtualTime) {
+        NativeHal::advanceTime(us);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+    if (virtualTime) return (uint32_t)(virtualMicros * 1000);
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) {
+    wait(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    wait(us);
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+// ========================================
+// TAREFAS
+// ========================================
+
+// Cada thread ganha, na primeira vez que precisa, o contador de
+// notificações que o FreeRTOS guarda em cada tarefa
+struct NativeTask {
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+};
+
+static thread_local NativeTask* currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    if (virtualTime) return pdPASS;
+
+    // Nunca liberada: as tarefas do firmware não terminam
+    NativeTask* state = new NativeTask();
+    if (handle) *handle = state;
+    std::thread([state, task, parameters] {
+        currentTask = state;
+        task(parameters);
+    }).detach();
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!currentTask) currentTask = new NativeTask();
+    return currentTask;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    NativeTask* state = static_cast<NativeTask*>(task);
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->notifications++;
+    }
+    state->wake.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    NativeTask* state = static_cast<NativeTask*>(xTaskGetCurrentTaskHandle());
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (!virtualTime) {
+        auto notified = [state] { return state->notifications > 0; };
+        if (ticksToWait == portMAX_DELAY) {
+            state->wake.wait(lock, notified);
+        } else {
+            state->wake.wait_for(lock, std::chrono::milliseconds(ticksToWait), notified);
+        }
+    }
+
+    uint32_t count = state->notifications;
+    if (count > 0) state->notifications = clearOnExit ? 0 : count - 1;
+    return count;
+}
+
+TickType_t xTaskGetTickCount() {
+    return millis();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
+
+// Mesmo contrato do FreeRTOS: acorda em *previousWake + increment, mesmo que
+// a volta anterior tenha atrasado
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    *previousWake += increment;
+    std::this_thread::sleep_until(bootTime + std::chrono::milliseconds(*previousWake));
+}
+
+// ========================================
+// PINOS
+// ========================================
+
+struct Interrupt {
+    void (*isr)();
+    void (*isrArg)(void*);
+    void* arg;
+    int mode;
+};
+
+// "levels" é o nível no pino; "latches" é o registrador de saída do GPIO,
+// que só chega ao pino enquanto o LEDC não o dirige (ledcPins)
+static std::atomic<int> levels[NativeHal::PIN_COUNT];
+static std::atomic<int> latches[NativeHal::PIN_COUNT];
+static std::atomic<bool> ledcPins[NativeHal::PIN_COUNT];
+static std::atomic<int> analogValues[NativeHal::PIN_COUNT];
+static std::atomic<int> duties[NativeHal::PIN_COUNT];
+static std::atomic<unsigned> tones[NativeHal::PIN_COUNT];
+static std::atomic<uint64_t> toneEnds[NativeHal::PIN_COUNT];  // 0 = sem fim
+static Interrupt interrupts[NativeHal::PIN_COUNT];
+
+static NativeHal::OutputListener outputListener = nullptr;
+static void* outputContext = nullptr;
+
+static void notifyOutput(uint8_t pin, NativeHal::OutputKind kind, int previous, int value) {
+    if (outputListener && previous != value) outputListener(pin, kind, value, outputContext);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= NativeHal::PIN_COUNT) return;
+    if (mode == INPUT_PULLUP) levels[pin] = HIGH;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < NativeHal::PIN_COUNT ? levels[pin].load() : LOW;
+}
+
+static void setLevel(uint8_t pin, int level) {
+    notifyOutput(pin, NativeHal::LEVEL, levels[pin].exchange(level), level);
+}
+
+// Como no ESP32, um pino ligado ao LEDC pela matriz do GPIO ignora o
+// registrador de saída até ser devolvido (ledcDetachPin)
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin >= NativeHal::PIN_COUNT) return;
+    int level = value ? HIGH : LOW;
+    latches[pin] = level;
+    if (!ledcPins[pin]) setLevel(pin, level);
+}
+
+gpio_dev_t GPIO;
+
+GpioWriteRegister& GpioWriteRegister::operator=(uint32_t mask) {
+    for (uint8_t pin = 0; pin < 32; pin++) {
+        if (mask & (1UL << pin)) digitalWrite(pin, level);
+    }
+    return *this;
+}
+
+GpioReadRegister::operator uint32_t() const {
+    uint32_t value = 0;
+    for (uint8_t bit = 0; bit < 32 && first + bit < NativeHal::PIN_COUNT; bit++) {
+        if (digitalRead(first + bit)) value |= 1UL << bit;
+    }
+    return value;
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return pin < NativeHal::PIN_COUNT ? analogValues[pin].load() : 0;
+}
+
+// Liga o pino ao LEDC; como nele, o pino passa a ler HIGH enquanto o duty
+// não é zero
+void analogWrite(uint8_t pin, int value) {
+    if (pin >= NativeHal::PIN_COUNT) return;
+    ledcPins[pin] = true;
+    notifyOutput(pin, NativeHal::DUTY, duties[pin].exchange(value), value);
+    setLevel(pin, value > 0 ? HIGH : LOW);
+}
+
+// Devolve o pino ao GPIO: ele volta a mostrar o registrador de saída
+void ledcDetachPin(uint8_t pin) {
+    if (pin >= NativeHal::PIN_COUNT || !ledcPins[pin].exchange(false)) return;
+    notifyOutput(pin, NativeHal::DUTY, duties[pin].exchange(0), 0);
+    setLevel(pin, latches[pin]);
+}
+
+// Sem ADC contínuo: o PotSampler usa a analogRead()
+int8_t digitalPinToAnalogChannel(uint8_t pin) {
+    return -1;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    if (pin >= NativeHal::PIN_COUNT) return;
+    int previous = NativeHal::toneFrequency(pin);
+    tones[pin] = frequency;
+    toneEnds[pin] = duration > 0 ? now64() + duration * 1000ULL : 0;
+    notifyOutput(pin, NativeHal::TONE, previous, frequency);
+}
+
+void noTone(uint8_t pin) {
+    if (pin >= NativeHal::PIN_COUNT) return;
+    int previous = NativeHal::toneFrequency(pin);
+    tones[pin] = 0;
+    notifyOutput(pin, NativeHal::TONE, previous, 0);
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    if (pin < NativeHal::PIN_COUNT) interrupts[pin] = { isr, nullptr, nullptr, mode };
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    if (pin < NativeHal::PIN_COUNT) interrupts[pin] = { nullptr, isr, arg, mode };
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < NativeHal::PIN_COUNT) interrupts[pin] = {};
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ========================================
+// SERIAL
+// ========================================
+
+HardwareSerial Serial;
+
+static std::mutex rxMutex;
+static std::deque<uint8_t> rxBuffer;
+static NativeHal::SerialSink txSink = nullptr;
+static void* txContext = nullptr;
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size--) written += write(*buffer++);
+    return written;
+}
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        yield();
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+String Stream::readStringUntil(char terminator) {
+    std::string line;
+    int c = timedRead();
+    while (c >= 0 && c != terminator) {
+        line += (char)c;
+        c = timedRead();
+    }
+    return String(line);
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> lock(rxMutex);
+    return (int)rxBuffer.size();
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> lock(rxMutex);
+    if (rxBuffer.empty()) return -1;
+    uint8_t c = rxBuffer.front();
+    rxBuffer.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> lock(rxMutex);
+    return rxBuffer.empty() ? -1 : rxBuffer.front();
+}
+
+// Sem UART de verdade, a escrita nunca bloqueia
+int HardwareSerial::availableForWrite() {
+    return 4096;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (txSink) {
+        txSink(buffer, size, txContext);
+    } else {
+        fwrite(buffer, 1, size, stdout);
+        fflush(stdout);
+    }
+    return size;
+}
+
+// ========================================
+// PREFERENCES (NVS em memória)
+// ========================================
+
+static std::mutex nvsMutex;
+static std::map<std::string, std::string> nvs;
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    space = std::string(name) + "/";
+    return true;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs.count(space + key) > 0;
+}
+
+bool Preferences::remove(const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs.erase(space + key) > 0;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvs[space + key] = value;
+    return strlen(value);
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto it = nvs.find(space + key);
+    return it == nvs.end() ? defaultValue : String(it->second);
+}
+
+// Mesmo contrato do ESP32: 0 se a chave não existe ou não cabe no buffer
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto it = nvs.find(space + key);
+    if (it == nvs.end() || it->second.size() + 1 > maxLength) return 0;
+    memcpy(value, it->second.c_str(), it->second.size() + 1);
+    return it->second.size() + 1;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvs[space + key] = std::string(static_cast<const char*>(value), length);
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto it = nvs.find(space + key);
+    return it == nvs.end() ? 0 : it->second.size();
+}
+
+// Mesmo contrato do ESP32: 0 se a chave não existe ou não cabe no buffer
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto it = nvs.find(space + key);
+    if (it == nvs.end() || it->second.size() > maxLength) return 0;
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+// ========================================
+// ADC CONTÍNUO (indisponível)
+// ========================================
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* init) { return ESP_ERR_NOT_SUPPORTED; }
+esp_err_t adc_digi_deinitialize() { return ESP_OK; }
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) { return ESP_ERR_NOT_SUPPORTED; }
+esp_err_t adc_digi_start() { return ESP_ERR_NOT_SUPPORTED; }
+esp_err_t adc_digi_stop() { return ESP_OK; }
+esp_err_t adc_digi_read_bytes(uint8_t* buffer, uint32_t maxLength, uint32_t* outLength, uint32_t timeoutMs) {
+    *outLength = 0;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// ========================================
+// ESP_TIMER
+// ========================================
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t period;     // 0 = uma vez só
+    uint64_t deadline;   // Instante do próximo disparo (micros)
+    bool armed;
+};
+
+// Recursivo: um callback pode rearmar ou parar o próprio temporizador
+static std::recursive_mutex timerMutex;
+static std::condition_variable_any timerChanged;
+static std::vector<esp_timer*> timerList;
+static bool timerThreadStarted = false;
+
+static esp_timer* nextTimer() {
+    esp_timer* next = nullptr;
+    for (esp_timer* timer : timerList) {
+        if (timer->armed && (next == nullptr || timer->deadline < next->deadline)) next = timer;
+    }
+    return next;
+}
+
+// Rearma antes do callback, como o esp_timer: o callback pode pará-lo
+static void fireTimer(esp_timer* timer) {
+    if (timer->period > 0) {
+        timer->deadline += timer->period;
+    } else {
+        timer->armed = false;
+    }
+    timer->callback(timer->arg);
+}
+
+// Faz o papel da tarefa do esp_timer (só em tempo real)
+static void timerThread() {
+    std::unique_lock<std::recursive_mutex> lock(timerMutex);
+    for (;;) {
+        esp_timer* next = nextTimer();
+        if (next == nullptr) {
+            timerChanged.wait(lock);
+        } else if (now64() < next->deadline) {
+            timerChanged.wait_until(lock, bootTime + std::chrono::microseconds(next->deadline));
+        } else {
+            fireTimer(next);
+        }
+    }
+}
+
+static esp_err_t startTimer(esp_timer* timer, uint64_t timeoutUs, uint64_t periodUs) {
+    std::lock_guard<std::recursive_mutex> lock(timerMutex);
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->deadline = now64() + timeoutUs;
+    timer->period = periodUs;
+    timer->armed = true;
+    timerChanged.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    std::lock_guard<std::recursive_mutex> lock(timerMutex);
+    if (!virtualTime && !timerThreadStarted) {
+        std::thread(timerThread).detach();
+        timerThreadStarted = true;
+    }
+    *handle = new esp_timer{ args->callback, args->arg, 0, 0, false };
+    timerList.push_back(*handle);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    return startTimer(timer, timeoutUs, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    return startTimer(timer, periodUs, periodUs);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    std::lock_guard<std::recursive_mutex> lock(timerMutex);
+    if (!timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    timerChanged.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    std::lock_guard<std::recursive_mutex> lock(timerMutex);
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    for (size_t i = 0; i < timerList.size(); i++) {
+        if (timerList[i] == timer) timerList.erase(timerList.begin() + i);
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)now64();
+}
+
+// ========================================
+// HARNESS
+// ========================================
+
+namespace NativeHal {
+
+void feedSerial(const uint8_t* data, size_t length) {
+    {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        rxBuffer.insert(rxBuffer.end(), data, data + length);
+    }
+    // O callback costuma ler a Serial: chamado sem a trava
+    if (Serial.receiveHandler()) Serial.receiveHandler()();
+}
+
+void feedSerial(const char* text) {
+    feedSerial(reinterpret_cast<const uint8_t*>(text), strlen(text));
+}
+
+void setSerialSink(SerialSink sink, void* context) {
+    txSink = sink;
+    txContext = context;
+}
+
+// Dispara a interrupção como o hardware faria: na thread de quem mudou o pino
+void setInput(uint8_t pin, int level) {
+    if (pin >= PIN_COUNT) return;
+    int previous = levels[pin].exchange(level ? HIGH : LOW);
+    if (previous == (level ? HIGH : LOW)) return;
+
+    const Interrupt& interrupt = interrupts[pin];
+    bool rising = level != LOW;
+    if (interrupt.mode == CHANGE || (interrupt.mode == RISING && rising) || (interrupt.mode == FALLING && !rising)) {
+        if (interrupt.isrArg) interrupt.isrArg(interrupt.arg);
+        else if (interrupt.isr) interrupt.isr();
+    }
+}
+
+void setAnalog(uint8_t pin, uint16_t value) {
+    if (pin < PIN_COUNT) analogValues[pin] = value;
+}
+
+int pinLevel(uint8_t pin) {
+    return pin < PIN_COUNT ? levels[pin].load() : LOW;
+}
+
+int pwmDuty(uint8_t pin) {
+    return pin < PIN_COUNT ? duties[pin].load() : 0;
+}
+
+// Um tone() com duração para sozinho: a frequência volta a 0 depois dela
+unsigned toneFrequency(uint8_t pin) {
+    if (pin >= PIN_COUNT) return 0;
+    uint64_t end = toneEnds[pin];
+    if (end != 0 && now64() > end) return 0;
+    return tones[pin];
+}
+
+void setOutputListener(OutputListener listener, void* context) {
+    outputListener = listener;
+    outputContext = context;
+}
+
+void useVirtualTime() {
+    virtualTime = true;
+}
+
+// Dispara os esp_timer vencidos, cada um com o relógio no seu instante, e
+// encerra os tone() com duração vencida, avisando o observador
+void advanceTime(unsigned long us) {
+    uint64_t target = virtualMicros + us;
+    {
+        std::lock_guard<std::recursive_mutex> lock(timerMutex);
+        for (esp_timer* next = nextTimer(); next && next->deadline <= target; next = nextTimer()) {
+            if (next->deadline > virtualMicros) virtualMicros = next->deadline;
+            fireTimer(next);
+        }
+    }
+    virtualMicros = target;
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+        uint64_t end = toneEnds[pin];
+        if (end != 0 && virtualMicros > end) {
+            toneEnds[pin] = 0;
+            notifyOutput(pin, TONE, tones[pin].exchange(0), 0);
+        }
+    }
+}
+
+}  // namespace NativeHal
@@ -0,0 +1,44 @@
+#ifndef HAL_NATIVE_H
+#define HAL_NATIVE_H
+
+#include <Arduino.h>
+
+// Controle do HAL nativo pelo harness (main.cpp, bench.cpp): faz o papel
+// do mundo externo ao ESP32, o host do outro lado da Serial e a placa
+namespace NativeHal {
+
+// Número de GPIOs do ESP32
+const uint8_t PIN_COUNT = 40;
+
+// Serial: bytes "recebidos" pelo firmware
+void feedSerial(const uint8_t* data, size_t length);
+void feedSerial(const char* text);
+
+// Serial: destino dos bytes enviados pelo firmware (nullptr = stdout)
+typedef void (*SerialSink)(const uint8_t* data, size_t length, void* context);
+void setSerialSink(SerialSink sink, void* context);
+
+// Entradas: nível de um pino digital (dispara a interrupção, se houver)
+// e valor lido pela analogRead() (0 a 4095)
+void setInput(uint8_t pin, int level);
+void setAnalog(uint8_t pin, uint16_t value);
+
+// Saídas: nível digital, duty da analogWrite() e frequência do tone() (0 = mudo)
+int pinLevel(uint8_t pin);
+int pwmDuty(uint8_t pin);
+unsigned toneFrequency(uint8_t pin);
+
+// Observador das saídas: chamado a cada mudança feita pelo firmware
+enum OutputKind { LEVEL, DUTY, TONE };
+typedef void (*OutputListener)(uint8_t pin, OutputKind kind, int value, void* context);
+void setOutputListener(OutputListener listener, void* context);
+
+// Tempo virtual (simulador): millis()/micros() só andam por advanceTime() e
+// as tarefas do FreeRTOS não são iniciadas, o harness as executa por conta
+// própria. Deve ser chamado antes do setup().
+void useVirtualTime();
+void advanceTime(unsigned long us);
+
+}  // namespace NativeHal
+
+#endif
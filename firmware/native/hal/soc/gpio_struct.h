@@ -0,0 +1,42 @@
+#ifndef SOC_GPIO_STRUCT_H
+#define SOC_GPIO_STRUCT_H
+
+#include <stdint.h>
+
+// Registradores do GPIO (só os usados pelo firmware). Como no
+// ESP32, cada bit em 1 escrito em out_w1ts liga o pino correspondente
+// (0 a 31) e em out_w1tc o desliga; os bits em 0 não mexem em nada.
+// No PC, cada pino tocado passa pelo digitalWrite() do HAL, que como no
+// ESP32 não muda um pino enquanto ele está ligado ao LEDC.
+class GpioWriteRegister {
+public:
+    explicit GpioWriteRegister(uint8_t level) : level(level) {}
+    GpioWriteRegister& operator=(uint32_t mask);
+
+private:
+    uint8_t level;
+};
+
+// Registradores de entrada: cada bit é o nível atual de um pino, a partir
+// de "first" (in: 0 a 31, in1: 32 a 39). No PC, lidos do digitalRead() do HAL.
+class GpioReadRegister {
+public:
+    explicit GpioReadRegister(uint8_t first) : first(first) {}
+    operator uint32_t() const;
+
+private:
+    uint8_t first;
+};
+
+struct gpio_dev_t {
+    GpioWriteRegister out_w1ts{1};
+    GpioWriteRegister out_w1tc{0};
+    GpioReadRegister in{0};
+    struct {
+        GpioReadRegister data{32};
+    } in1;
+};
+
+extern gpio_dev_t GPIO;
+
+#endif
@@ -0,0 +1,27 @@
+// ========================================
+// FIRMWARE NO PC
+// ========================================
+// Roda setup()/loop() sem alterações: stdin faz o papel da Serial recebida
+// e stdout o da enviada. Exemplo:
+//   echo '{"type":"GET_VERSION"}' | .pio/build/native/program
+
+#include "hal/hal_native.h"
+
+#include <stdio.h>
+#include <thread>
+
+int main() {
+    // A leitura do stdin bloqueia, então fica numa thread separada
+    std::thread([] {
+        int c;
+        while ((c = getchar()) != EOF) {
+            uint8_t byte = (uint8_t)c;
+            NativeHal::feedSerial(&byte, 1);
+        }
+    }).detach();
+
+    setup();
+    for (;;) {
+        loop();
+    }
+}
@@ -0,0 +1,4 @@
+// Compila o sketch como uma unidade C++ comum. No ESP32 o pré-processador do
+// Arduino faz isso com o .ino; aqui o HAL nativo faz o papel do core.
+#include <Arduino.h>
+#include "ninho.ino"
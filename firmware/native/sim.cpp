@@ -0,0 +1,249 @@
+// ========================================
+// SIMULADOR DE MISSÕES (TEMPO VIRTUAL)
+// ========================================
+// Executa a lógica das missões do ninho.ino num relógio virtual, sem a
+// tarefa do FreeRTOS: cada tick de 1ms é uma chamada de missionStep().
+// Um roteiro dita missão, botão e potenciômetro ao longo do tempo, e cada
+// mudança das saídas é registrada com seu instante. As ações que são
+// comandos (mission, load, param, play) viram uma linha JSON e passam pelo
+// mesmo handleCommand() da Serial: parse, tratador e resposta.
+//
+// Uso: native_sim [-q] roteiro.sim    (-q: só o resultado das verificações)
+//
+// Roteiro: uma ação por linha, em ordem de tempo (ms); '#' inicia comentário
+//   0     mission MISSION_4_STATE_MACHINE
+//   0     load AQEAAAAIAAfQAgEA  (programa da missão CUSTOM em base64, LOAD_MISSION)
+//   100   button 1          (1 = pressionado, 0 = solto)
+//   300   pot 2048
+//   400   param blinkMs 50  (SET_PARAM; sem missão, vale a do último SET_MISSION,
+//                            ou a indicada no fim: param blinkMs 50 MISSION_5_FINAL)
+//   500   play t:d=8,o=5,b=120:c,d,p,e  (PLAY com RTTTL; "0" no fim: sem repetir)
+//   1000  expect led 1      (confere depois do tick desse instante)
+//   5000  end               (opcional: por padrão termina na última ação)
+//
+// Sinais (no registro e no expect): led, led2, buzzer (nível digital),
+// led_pwm, led2_pwm (duty da analogWrite) e tone (Hz do buzzer, 0 = mudo)
+
+#include <Arduino.h>
+#include "ninho.ino"
+#include "hal/hal_native.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+struct Action {
+    unsigned long time;
+    std::string verb;
+    std::string name;
+    long value;
+    int line;
+    MissionId mission;  // param: missão alvo (IDLE = sem "missionId")
+};
+
+struct Signal {
+    const char* name;
+    uint8_t pin;
+    NativeHal::OutputKind kind;
+};
+
+static const Signal SIGNALS[] = {
+    { "led",      PIN_LED,    NativeHal::LEVEL },
+    { "led2",     PIN_LED_2,  NativeHal::LEVEL },
+    { "buzzer",   PIN_BUZZER, NativeHal::LEVEL },
+    { "led_pwm",  PIN_LED,    NativeHal::DUTY },
+    { "led2_pwm", PIN_LED_2,  NativeHal::DUTY },
+    { "tone",     PIN_BUZZER, NativeHal::TONE },
+};
+
+static const Signal* findSignal(const std::string& name) {
+    for (const Signal& signal : SIGNALS) {
+        if (name == signal.name) return &signal;
+    }
+    return nullptr;
+}
+
+static const Signal* findSignal(uint8_t pin, NativeHal::OutputKind kind) {
+    for (const Signal& signal : SIGNALS) {
+        if (signal.pin == pin && signal.kind == kind) return &signal;
+    }
+    return nullptr;
+}
+
+static int readSignal(const Signal& signal) {
+    switch (signal.kind) {
+        case NativeHal::LEVEL: return NativeHal::pinLevel(signal.pin);
+        case NativeHal::DUTY:  return NativeHal::pwmDuty(signal.pin);
+        case NativeHal::TONE:  return NativeHal::toneFrequency(signal.pin);
+    }
+    return 0;
+}
+
+// Registro das transições: "<ms> <sinal> <valor>"
+static void onOutput(uint8_t pin, NativeHal::OutputKind kind, int value, void* context) {
+    const Signal* signal = findSignal(pin, kind);
+    if (signal == nullptr) return;
+    printf("%10.3f %-8s %d\n", micros() / 1000.0, signal->name, value);
+}
+
+// Respostas do firmware aos comandos do roteiro
+static std::string replies;
+
+static void collectSerial(const uint8_t* data, size_t length, void* context) {
+    replies.append(reinterpret_cast<const char*>(data), length);
+}
+
+// Entrega um comando como se tivesse chegado pela Serial; false se a
+// resposta foi um ERROR
+static bool runCommand(const std::string& json) {
+    replies.clear();
+    std::vector<char> line(json.begin(), json.end());
+    handleCommand(line.data(), line.size());
+    return replies.find("\"type\":\"ERROR\"") == std::string::npos;
+}
+
+static bool loadScript(FILE* file, std::vector<Action>& actions) {
+    char buffer[512];
+    int line = 0;
+    unsigned long last = 0;
+
+    while (fgets(buffer, sizeof(buffer), file)) {
+        line++;
+        char* comment = strchr(buffer, '#');
+        if (comment) *comment = '\0';
+
+        char verb[32] = "", name[400] = "", extra[32] = "", target[32] = "";
+        unsigned long time = 0;
+        int fields = sscanf(buffer, "%lu %31s %399s %31s %31s", &time, verb, name, extra, target);
+        if (fields <= 0) continue;  // Linha vazia
+
+        Action action = { time, verb, name, 0, line, MissionId::IDLE };
+        std::string value = fields == 4 ? extra : name;
+
+        bool valid = fields >= 2 && time >= last;
+        if (action.verb == "mission") {
+            MissionId id = MissionId::IDLE;
+            valid = valid && fields == 3 && MissionRegistry::lookup(name, strlen(name), id);
+            action.value = static_cast<long>(id);
+        } else if (action.verb == "load") {
+            valid = valid && fields == 3;
+        } else if (action.verb == "param") {
+            valid = valid && (fields == 4
+                              || (fields == 5 && MissionRegistry::lookup(target, strlen(target), action.mission)));
+            action.value = atol(extra);
+        } else if (action.verb == "play") {
+            valid = valid && (fields == 3 || fields == 4);
+            action.value = fields == 4 ? atol(extra) : 1;
+        } else if (action.verb == "button" || action.verb == "pot") {
+            valid = valid && fields == 3;
+            action.value = atol(name);
+        } else if (action.verb == "expect") {
+            valid = valid && fields == 4 && findSignal(action.name) != nullptr;
+            action.value = atol(extra);
+        } else if (action.verb != "end") {
+            valid = false;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "linha %d: acao invalida\n", line);
+            return false;
+        }
+        last = time;
+        actions.push_back(action);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    bool quiet = argc > 1 && strcmp(argv[1], "-q") == 0;
+    const char* path = argc > (quiet ? 2 : 1) ? argv[quiet ? 2 : 1] : nullptr;
+
+    FILE* file = path ? fopen(path, "r") : stdin;
+    if (file == nullptr) {
+        fprintf(stderr, "nao foi possivel abrir %s\n", path);
+        return 2;
+    }
+
+    std::vector<Action> actions;
+    bool loaded = loadScript(file, actions);
+    if (path) fclose(file);
+    if (!loaded) return 2;
+    if (actions.empty()) return 0;
+
+    NativeHal::useVirtualTime();
+    NativeHal::setSerialSink(collectSerial, nullptr);
+    if (!quiet) NativeHal::setOutputListener(onOutput, nullptr);
+    setup();
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned long end = actions.back().time;
+    unsigned failures = 0;
+    size_t next = 0;
+
+    for (unsigned long now = 0; now <= end; now++) {
+        // Entradas deste instante, antes do tick
+        size_t expects = next;
+        while (next < actions.size() && actions[next].time == now) {
+            const Action& action = actions[next++];
+            if (action.verb == "mission") {
+                if (!runCommand("{\"type\":\"SET_MISSION\",\"missionId\":\"" + action.name + "\"}")) {
+                    failures++;
+                    printf("FALHA linha %d: missao recusada\n", action.line);
+                }
+            } else if (action.verb == "load") {
+                // LOAD_MISSION com o programa inteiro num pedaço só
+                const std::string& data = action.name;
+                size_t padding = data.size() - data.find_last_not_of('=') - 1;
+                long size = (long)(data.size() * 3 / 4 - padding);
+                if (!runCommand("{\"type\":\"LOAD_MISSION\",\"offset\":0,\"size\":" + std::to_string(size)
+                                + ",\"data\":\"" + data + "\"}")) {
+                    failures++;
+                    printf("FALHA linha %d: programa invalido\n", action.line);
+                }
+            } else if (action.verb == "play") {
+                std::string loop = action.value != 0 ? "true" : "false";
+                if (!runCommand("{\"type\":\"PLAY\",\"rtttl\":\"" + action.name + "\",\"loop\":" + loop + "}")) {
+                    failures++;
+                    printf("FALHA linha %d: melodia invalida\n", action.line);
+                }
+            } else if (action.verb == "param") {
+                std::string json = "{\"type\":\"SET_PARAM\",\"param\":\"" + action.name
+                                 + "\",\"value\":" + std::to_string(action.value);
+                if (action.mission != MissionId::IDLE) {
+                    json += ",\"missionId\":\"" + std::string(MissionRegistry::name(action.mission)) + "\"";
+                }
+                if (!runCommand(json + "}")) {
+                    failures++;
+                    printf("FALHA linha %d: parametro invalido\n", action.line);
+                }
+            } else if (action.verb == "button") {
+                NativeHal::setInput(PIN_BUTTON, action.value ? HIGH : LOW);
+            } else if (action.verb == "pot") {
+                NativeHal::setAnalog(PIN_POT, (uint16_t)action.value);
+            }
+        }
+
+        missionStep();
+
+        // Verificações deste instante, depois do tick
+        for (size_t i = expects; i < next; i++) {
+            const Action& action = actions[i];
+            if (action.verb != "expect") continue;
+
+            int actual = readSignal(*findSignal(action.name));
+            if (actual != action.value) {
+                failures++;
+                printf("FALHA linha %d: %lu ms %s = %d (esperado %ld)\n",
+                       action.line, now, action.name.c_str(), actual, action.value);
+            }
+        }
+
+        NativeHal::advanceTime(1000);
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("%s: %lu ms simulados em %.1f ms (%.0fx), %u falha(s)\n",
+           failures ? "FALHOU" : "OK", end + 1, elapsed, (end + 1) / (elapsed > 0 ? elapsed : 1), failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+#include "base64.h"
+
+namespace Base64 {
+
+// Valor de um caractere base64, ou -1
+static int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+long decode(const char* text, uint8_t* out, size_t room) {
+    size_t written = 0;
+    uint32_t bits = 0;
+    uint8_t count = 0;
+
+    for (const char* c = text; *c != '\0' && *c != '='; c++) {
+        int value = base64Value(*c);
+        if (value < 0) return -1;
+        bits = (bits << 6) | value;
+        if (++count == 4) {
+            if (written + 3 > room) return -1;
+            out[written++] = bits >> 16;
+            out[written++] = bits >> 8;
+            out[written++] = bits;
+            bits = 0;
+            count = 0;
+        }
+    }
+
+    // Sobra de 2 ou 3 caracteres: 1 ou 2 bytes
+    if (count == 1) return -1;
+    if (count > 1) {
+        bits <<= 6 * (4 - count);
+        if (written + count - 1 > room) return -1;
+        out[written++] = bits >> 16;
+        if (count == 3) out[written++] = bits >> 8;
+    }
+    return (long)written;
+}
+
+}  // namespace Base64
@@ -0,0 +1,15 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <Arduino.h>
+
+// Dados binários dentro do JSON (LOAD_MISSION, PLAY)
+namespace Base64 {
+
+// Decodifica base64 (com ou sem '=' no fim). Retorna o número de bytes
+// escritos, ou -1 se o texto for inválido ou não couber em room.
+long decode(const char* text, uint8_t* out, size_t room);
+
+}  // namespace Base64
+
+#endif
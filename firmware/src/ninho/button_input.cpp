@@ -0,0 +1,78 @@
+#include "button_input.h"
+#include <esp_timer.h>
+#include <soc/gpio_struct.h>
+
+void ButtonInput::begin(uint8_t buttonPin, uint32_t debounceMicros) {
+    pin = buttonPin;
+    debounce = debounceMicros;
+
+    isrLevel = digitalRead(pin);
+    rawLevel = isrLevel;
+    stableLevel = isrLevel;
+    lastAccepted = micros() - debounce;
+
+    attachInterruptArg(digitalPinToInterrupt(pin), onEdge, this, CHANGE);
+}
+
+// Nível do pino lido direto no registrador de entrada do GPIO
+static inline uint8_t IRAM_ATTR readLevel(uint8_t pin) {
+    if (pin < 32) return (GPIO.in >> pin) & 1;
+    return (GPIO.in1.data >> (pin - 32)) & 1;
+}
+
+// Roda com a cache da flash possivelmente desligada (ex: gravando a NVS):
+// tudo o que ela chama precisa estar na IRAM. micros() e digitalRead() do
+// core ficam na flash; esp_timer_get_time() está na IRAM e conta no mesmo
+// relógio do micros(), e o push da fila é expandido aqui.
+void IRAM_ATTR ButtonInput::onEdge(void* arg) {
+    ButtonInput* self = static_cast<ButtonInput*>(arg);
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint8_t level = readLevel(self->pin);
+
+    // Repiques rápidos podem gerar interrupções sem mudança de nível
+    if (level == self->isrLevel) {
+        return;
+    }
+    self->isrLevel = level;
+
+    RawEdge raw = { now, level };
+    if (!self->edges.push(raw)) {
+        self->overflowed.store(true, std::memory_order_release);
+    }
+}
+
+bool ButtonInput::accept(uint8_t level, uint32_t time, ButtonEdge& edge) {
+    // Mesmo nível ou ainda dentro da janela de debounce: é repique
+    if (level == stableLevel || time - lastAccepted < debounce) {
+        return false;
+    }
+
+    stableLevel = level;
+    lastAccepted = time;
+    edge.time = time;
+    edge.pressed = (level == HIGH);
+    return true;
+}
+
+bool ButtonInput::next(ButtonEdge& edge, uint32_t now) {
+    RawEdge raw;
+    while (edges.pop(raw)) {
+        rawLevel = raw.level;
+        if (accept(raw.level, raw.time, edge)) {
+            return true;
+        }
+    }
+
+    // Fila transbordou: o nível real do pino passa a valer
+    if (overflowed.exchange(false, std::memory_order_acquire)) {
+        rawLevel = digitalRead(pin);
+    }
+
+    // A última borda caiu dentro da janela de debounce e o nível ficou
+    // diferente do aceito (ex: toque muito curto). Passada a janela, ele vale.
+    if (rawLevel != stableLevel && now - lastAccepted >= debounce) {
+        return accept(rawLevel, lastAccepted + debounce, edge);
+    }
+
+    return false;
+}
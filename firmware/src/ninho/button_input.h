@@ -0,0 +1,54 @@
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "spsc_queue.h"
+
+// Uma borda do botão já filtrada pelo debounce
+struct ButtonEdge {
+    uint32_t time;   // micros() do instante da borda (medido na interrupção)
+    bool pressed;    // true = apertou (subida), false = soltou (descida)
+};
+
+// Leitura do botão por interrupção.
+// A interrupção só anota o instante (micros) e o nível de cada borda em uma
+// fila sem trava; o debounce é aplicado sobre esses instantes, então um
+// aperto é detectado mesmo que a tarefa das missões esteja ocupada e mesmo
+// que dure menos que uma iteração.
+class ButtonInput {
+public:
+    void begin(uint8_t pin, uint32_t debounceMicros);
+
+    // Entrega a próxima borda filtrada. Chamar até retornar false.
+    // "now" é o micros() atual, usado para confirmar um nível que assentou
+    // durante a janela de debounce sem gerar uma nova interrupção.
+    bool next(ButtonEdge& edge, uint32_t now);
+
+    // Nível filtrado atual (true = pressionado)
+    bool pressed() const { return stableLevel == HIGH; }
+
+private:
+    struct RawEdge {
+        uint32_t time;
+        uint8_t level;
+    };
+
+    static void IRAM_ATTR onEdge(void* arg);
+    bool accept(uint8_t level, uint32_t time, ButtonEdge& edge);
+
+    uint8_t pin = 0;
+    uint32_t debounce = 0;
+
+    // Escritos apenas pela interrupção
+    SpscQueue<RawEdge, 64> edges;
+    uint8_t isrLevel = LOW;
+    std::atomic<bool> overflowed{false};
+
+    // Escritos apenas por quem chama next()
+    uint8_t rawLevel = LOW;
+    uint8_t stableLevel = LOW;
+    uint32_t lastAccepted = 0;
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "command_reader.h"
+
+void CommandReader::reset() {
+    used = 0;
+    lineStart = 0;
+    lineLength = 0;
+    delivered = 0;
+    discarding = false;
+    skipping = 0;
+}
+
+void CommandReader::discard(size_t count) {
+    used -= count;
+    memmove(buffer, buffer + count, used);
+}
+
+CommandReader::Status CommandReader::poll(Stream& in) {
+    // Remove o comando entregue na chamada anterior (e o seu delimitador)
+    if (delivered > 0) {
+        discard(delivered);
+        delivered = 0;
+        lineStart = 0;
+        lineLength = 0;
+    }
+
+    // Copia somente o que já chegou: readBytes() não espera se pedirmos
+    // no máximo available() bytes
+    int available = in.available();
+    if (available > 0) {
+        size_t room = CAPACITY - used;
+        size_t count = (size_t)available < room ? (size_t)available : room;
+        used += in.readBytes(buffer + used, count);
+    }
+
+    switch (framing) {
+        case LENGTH_PREFIXED: return nextFrame();
+        case COBS: return nextCobsFrame();
+        default: return nextLine();
+    }
+}
+
+CommandReader::Status CommandReader::nextLine() {
+    while (used > 0) {
+        char* newline = (char*)memchr(buffer, '\n', used);
+
+        if (discarding) {
+            // Joga fora tudo até o fim da linha longa demais
+            if (newline == nullptr) {
+                used = 0;
+                return NONE;
+            }
+            discard(newline - buffer + 1);
+            discarding = false;
+            continue;
+        }
+
+        if (newline == nullptr) {
+            if (used > MAX_LINE) {
+                used = 0;
+                discarding = true;
+                return TOO_LONG;
+            }
+            return NONE;
+        }
+
+        size_t length = newline - buffer;
+        *newline = '\0';
+
+        // Aceita "\r\n" vindo de terminais
+        if (length > 0 && buffer[length - 1] == '\r') {
+            buffer[--length] = '\0';
+        }
+
+        if (length == 0) {
+            // Linha vazia: descarta e procura a próxima
+            discard(newline - buffer + 1);
+            continue;
+        }
+
+        // O buffer cabe um pouco mais que MAX_LINE (folga do COBS): uma
+        // linha longa que chegou inteira numa leitura também é recusada
+        if (length > MAX_LINE) {
+            discard(newline - buffer + 1);
+            return TOO_LONG;
+        }
+
+        // A linha fica no buffer até a próxima chamada
+        lineLength = length;
+        delivered = newline - buffer + 1;
+        return LINE;
+    }
+
+    return NONE;
+}
+
+CommandReader::Status CommandReader::nextFrame() {
+    // Termina de descartar um quadro longo demais
+    if (skipping > 0) {
+        size_t count = skipping < used ? skipping : used;
+        discard(count);
+        skipping -= count;
+        if (skipping > 0) {
+            return NONE;
+        }
+    }
+
+    if (used < 2) {
+        return NONE;
+    }
+
+    size_t length = ((uint8_t)buffer[0] << 8) | (uint8_t)buffer[1];
+
+    if (length > MAX_LINE) {
+        discard(2);
+        skipping = length;
+        return TOO_LONG;
+    }
+
+    if (used < 2 + length) {
+        return NONE;
+    }
+
+    // O quadro fica no buffer (depois do prefixo) até a próxima chamada
+    lineStart = 2;
+    lineLength = length;
+    delivered = 2 + length;
+    return LINE;
+}
+
+CommandReader::Status CommandReader::nextCobsFrame() {
+    while (used > 0) {
+        uint8_t* end = (uint8_t*)memchr(buffer, 0, used);
+
+        if (discarding) {
+            // Joga fora tudo até o fim do quadro longo demais
+            if (end == nullptr) {
+                used = 0;
+                return NONE;
+            }
+            discard(end - (uint8_t*)buffer + 1);
+            discarding = false;
+            continue;
+        }
+
+        if (end == nullptr) {
+            if (used >= CAPACITY) {
+                used = 0;
+                discarding = true;
+                return TOO_LONG;
+            }
+            return NONE;
+        }
+
+        size_t encoded = end - (uint8_t*)buffer;
+        if (encoded == 0) {
+            // 0x00 repetido (o host pode mandar um para ressincronizar)
+            discard(1);
+            continue;
+        }
+
+        int length = FrameCodec::decode((uint8_t*)buffer, encoded);
+        if (length == 0) {
+            // Só o CRC: nada a entregar
+            discard(encoded + 1);
+            continue;
+        }
+
+        // O quadro e o seu 0x00 saem do buffer na próxima chamada, válido ou não
+        delivered = encoded + 1;
+        if (length < 0) {
+            return BAD_FRAME;
+        }
+        if ((size_t)length > MAX_LINE) {
+            return TOO_LONG;
+        }
+
+        lineLength = length;
+        return LINE;
+    }
+
+    return NONE;
+}
@@ -0,0 +1,73 @@
+#ifndef COMMAND_READER_H
+#define COMMAND_READER_H
+
+#include <Arduino.h>
+#include "frame_codec.h"
+
+// Monta comandos a partir da Serial sem nunca bloquear.
+// Cada chamada de poll() copia apenas os bytes já recebidos para um buffer
+// fixo; quando um comando completo está disponível, ele é entregue no
+// próprio buffer para ser analisado sem cópia.
+//
+// Enquadramentos suportados:
+// - LINES: texto terminado em '\n' (JSON). A linha é terminada em '\0'.
+// - LENGTH_PREFIXED: 2 bytes de tamanho (big-endian) seguidos do conteúdo
+//   binário (MessagePack).
+// - COBS: conteúdo (JSON ou MessagePack) com CRC-16, codificado em COBS e
+//   terminado em 0x00 (ver frame_codec.h). O quadro é decodificado e
+//   conferido no próprio buffer; um quadro corrompido é descartado até o
+//   próximo 0x00 sem passar pelo parser.
+class CommandReader {
+public:
+    // Tamanho máximo de um comando (sem o '\n' ou o prefixo de tamanho)
+    static const size_t MAX_LINE = 256;
+
+    enum Framing {
+        LINES,
+        LENGTH_PREFIXED,
+        COBS
+    };
+
+    enum Status {
+        NONE,      // Nenhum comando completo ainda
+        LINE,      // line()/length() contêm um comando completo
+        TOO_LONG,  // Um comando passou de MAX_LINE e foi descartado
+        BAD_FRAME  // Quadro COBS inválido ou com CRC errado (descartado)
+    };
+
+    Status poll(Stream& in);
+
+    // Vale para os próximos bytes; o que já está no buffer é reinterpretado
+    void setFraming(Framing mode) { framing = mode; }
+
+    // Descarta tudo o que foi recebido até aqui (ex: bytes lidos na
+    // velocidade errada durante uma troca de baud)
+    void reset();
+
+    // Válidos até a próxima chamada de poll()
+    char* line() { return buffer + lineStart; }
+    size_t length() const { return lineLength; }
+
+private:
+    // Remove os primeiros bytes do buffer
+    void discard(size_t count);
+
+    Status nextLine();
+    Status nextFrame();
+    Status nextCobsFrame();
+
+    // Cabe um comando de MAX_LINE bytes mais o '\n', o prefixo, ou o CRC
+    // codificado em COBS com o 0x00 final
+    static const size_t CAPACITY = FrameCodec::encodedSize(MAX_LINE + FrameCodec::CRC_SIZE) + 1;
+
+    char buffer[CAPACITY];
+    Framing framing = LINES;
+    size_t used = 0;          // Bytes ocupados no buffer
+    size_t lineStart = 0;     // Início do comando entregue
+    size_t lineLength = 0;    // Tamanho do comando entregue
+    size_t delivered = 0;     // Bytes a remover na próxima chamada
+    bool discarding = false;  // Descartando o resto de uma linha/quadro COBS longo demais
+    size_t skipping = 0;      // Bytes de um quadro longo demais ainda a descartar
+};
+
+#endif
@@ -0,0 +1,36 @@
+#include "deadline_scheduler.h"
+
+uint8_t DeadlineScheduler::add(Callback fire) {
+    timers[count] = { fire, 0, false };
+    return count++;
+}
+
+void DeadlineScheduler::at(uint8_t timer, unsigned long deadline) {
+    timers[timer].deadline = deadline;
+    timers[timer].armed = true;
+}
+
+void DeadlineScheduler::cancel(uint8_t timer) {
+    timers[timer].armed = false;
+}
+
+void DeadlineScheduler::run(unsigned long now) {
+    for (uint8_t i = 0; i < count; i++) {
+        Timer& timer = timers[i];
+        if (timer.armed && due(timer.deadline, now)) {
+            timer.armed = false;
+            timer.fire(now);
+        }
+    }
+}
+
+unsigned long DeadlineScheduler::timeUntilNext(unsigned long now, unsigned long limit) const {
+    unsigned long wait = limit;
+    for (uint8_t i = 0; i < count; i++) {
+        const Timer& timer = timers[i];
+        if (!timer.armed) continue;
+        if (due(timer.deadline, now)) return 0;
+        if (timer.deadline - now < wait) wait = timer.deadline - now;
+    }
+    return wait;
+}
@@ -0,0 +1,47 @@
+#ifndef DEADLINE_SCHEDULER_H
+#define DEADLINE_SCHEDULER_H
+
+#include <Arduino.h>
+
+// Prazos absolutos (millis) da tarefa de comunicação.
+// Cada tarefa periódica (telemetria, volta da velocidade da Serial) registra
+// um temporizador e o arma para o instante em que precisa rodar; o loop()
+// dispara os vencidos e dorme até o próximo, em vez de girar comparando
+// millis() a cada volta. Rearmar a partir do prazo anterior (e não do
+// instante em que o callback rodou) mantém o período exato.
+class DeadlineScheduler {
+public:
+    static const uint8_t MAX_TIMERS = 4;
+
+    typedef void (*Callback)(unsigned long now);
+
+    // Registra um temporizador (desarmado). Retorna o seu índice.
+    uint8_t add(Callback fire);
+
+    void at(uint8_t timer, unsigned long deadline);
+    void cancel(uint8_t timer);
+    bool armed(uint8_t timer) const { return timers[timer].armed; }
+    unsigned long deadline(uint8_t timer) const { return timers[timer].deadline; }
+
+    // Dispara os vencidos. Cada um é desarmado antes do callback, que pode
+    // rearmá-lo.
+    void run(unsigned long now);
+
+    // Milissegundos até o próximo prazo, no máximo limit (0 = já venceu)
+    unsigned long timeUntilNext(unsigned long now, unsigned long limit) const;
+
+private:
+    struct Timer {
+        Callback fire;
+        unsigned long deadline;
+        bool armed;
+    };
+
+    // Compara pela diferença: vale mesmo quando o millis() dá a volta
+    static bool due(unsigned long deadline, unsigned long now) { return (long)(now - deadline) >= 0; }
+
+    Timer timers[MAX_TIMERS] = {};
+    uint8_t count = 0;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "frame_codec.h"
+
+namespace FrameCodec {
+
+struct CrcTable {
+    uint16_t values[256];
+};
+
+// Montada pelo compilador: um acesso à tabela por byte em vez de 8 deslocamentos
+constexpr CrcTable buildCrcTable() {
+    CrcTable table = {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint16_t crc = i << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+        table.values[i] = crc;
+    }
+    return table;
+}
+
+constexpr CrcTable CRC_TABLE = buildCrcTable();
+
+// Valor de referência do CRC-16/CCITT-FALSE
+static_assert(CRC_TABLE.values[1] == 0x1021 && CRC_TABLE.values[255] == 0x1EF0,
+              "Tabela do CRC-16 incorreta");
+
+uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc << 8) ^ CRC_TABLE.values[(crc >> 8) ^ data[i]];
+    }
+    return crc;
+}
+
+size_t encode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeAt = 0;   // Onde vai o código do bloco atual
+    size_t written = 1;
+    uint8_t code = 1;    // Bytes do bloco atual + 1
+
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] == 0) {
+            out[codeAt] = code;
+            codeAt = written++;
+            code = 1;
+            continue;
+        }
+
+        out[written++] = in[i];
+        if (++code == 0xFF) {
+            // Bloco cheio: 254 bytes sem zero
+            out[codeAt] = code;
+            codeAt = written++;
+            code = 1;
+        }
+    }
+
+    out[codeAt] = code;
+    return written;
+}
+
+int decode(uint8_t* data, size_t length) {
+    size_t read = 0;
+    size_t written = 0;
+
+    // Uma passada só: o conteúdo decodificado nunca ultrapassa o codificado
+    while (read < length) {
+        uint8_t code = data[read++];
+        if (code == 0 || read + code - 1 > length) {
+            return -1;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            data[written++] = data[read++];
+        }
+        if (code != 0xFF && read < length) {
+            data[written++] = 0;
+        }
+    }
+
+    if (written < CRC_SIZE) {
+        return -1;
+    }
+
+    size_t content = written - CRC_SIZE;
+    uint16_t received = (data[content] << 8) | data[content + 1];
+    if (crc16(data, content) != received) {
+        return -1;
+    }
+    return (int)content;
+}
+
+}  // namespace FrameCodec
@@ -0,0 +1,38 @@
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <Arduino.h>
+
+// Enquadramento COBS com CRC-16, o mesmo nos dois sentidos:
+//
+//   COBS(conteúdo + CRC-16 big-endian) + 0x00
+//
+// O COBS tira todos os 0x00 do quadro, então o 0x00 só aparece como
+// delimitador: depois de um erro, basta pular até o próximo 0x00 para
+// voltar a ler quadros inteiros. O CRC-16/CCITT-FALSE (polinômio 0x1021,
+// valor inicial 0xFFFF) rejeita quadros corrompidos antes de o conteúdo
+// (JSON ou MessagePack) chegar ao parser.
+namespace FrameCodec {
+
+// Bytes do CRC no fim do conteúdo
+constexpr size_t CRC_SIZE = 2;
+
+// Pior caso do COBS: um byte a mais a cada 254 (mais o primeiro)
+constexpr size_t encodedSize(size_t length) {
+    return length + length / 254 + 1;
+}
+
+uint16_t crc16(const uint8_t* data, size_t length);
+
+// Codifica length bytes de in em out, sem o 0x00 final, e retorna o tamanho
+// escrito. out pode começar antes de in no mesmo buffer, desde que
+// in - out >= encodedSize(length) - length.
+size_t encode(const uint8_t* in, size_t length, uint8_t* out);
+
+// Decodifica no próprio buffer (sem o 0x00 final) e confere o CRC.
+// Retorna o tamanho do conteúdo, sem o CRC, ou -1 se o quadro for inválido.
+int decode(uint8_t* data, size_t length);
+
+}  // namespace FrameCodec
+
+#endif
@@ -0,0 +1,44 @@
+#include "loop_profiler.h"
+
+void LoopProfiler::begin() {
+    cyclesPerMicro = ESP.getCpuFreqMHz();
+    reset();
+}
+
+void LoopProfiler::record(Stage stage, uint32_t start) {
+    // Diferença sem sinal: continua certa quando o contador dá a volta
+    uint32_t cycles = now() - start;
+    uint32_t micros = cycles / cyclesPerMicro;
+
+    uint8_t bucket = 0;
+    if (micros > 0) {
+        bucket = 32 - __builtin_clz(micros);
+        if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+    }
+
+    Histogram& histogram = histograms[stage];
+    histogram.count++;
+    histogram.totalCycles += cycles;
+    histogram.buckets[bucket]++;
+    if (micros > histogram.maxMicros) histogram.maxMicros = micros;
+}
+
+void LoopProfiler::reset() {
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        histograms[i] = {};
+    }
+    missed = 0;
+    overflows = 0;
+}
+
+const char* LoopProfiler::name(Stage stage) {
+    switch (stage) {
+        case LOOP: return "loop";
+        case READ: return "read";
+        case PARSE: return "parse";
+        case MISSION: return "mission";
+        case SERIALIZE: return "serialize";
+        case WRITE: return "write";
+        default: return "";
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+
+// Mede quanto tempo cada etapa do firmware leva, com o contador de ciclos da
+// CPU (ESP.getCycleCount(): a leitura de um registrador, sem chamada ao IDF).
+// Cada etapa guarda um histograma de faixas fixas, então medir não aloca nada
+// e o custo por medida é constante.
+//
+// Cada etapa é gravada por uma única tarefa (MISSION pela tarefa das missões,
+// as outras pelo loop()), então não há disputa entre os núcleos. A leitura
+// pelo GET_METRICS pode pegar um histograma no meio de uma atualização, o que
+// só afeta uma contagem.
+class LoopProfiler {
+public:
+    enum Stage : uint8_t {
+        LOOP,        // Uma volta inteira do loop()
+        READ,        // CommandReader::poll()
+        PARSE,       // Protocol::parse()
+        MISSION,     // Uma volta da tarefa das missões (missionStep)
+        SERIALIZE,   // JSON/MessagePack de uma mensagem enviada
+        WRITE,       // Serial.write() de uma mensagem enviada
+        STAGE_COUNT
+    };
+
+    // Faixas em potências de 2 de microssegundos: a faixa 0 é < 1µs e a
+    // faixa i vai de 2^(i-1) a 2^i - 1µs; a última acumula tudo acima
+    static const uint8_t BUCKETS = 16;
+
+    struct Histogram {
+        uint32_t count;
+        uint32_t maxMicros;
+        uint64_t totalCycles;   // Soma das medidas em ciclos (sem perder as frações de µs)
+        uint32_t buckets[BUCKETS];
+    };
+
+    void begin();
+
+    static uint32_t now() { return ESP.getCycleCount(); }
+
+    // Fecha uma medida iniciada com now()
+    void record(Stage stage, uint32_t start);
+
+    // A tarefa das missões passou do seu período
+    void missedDeadline() { missed++; }
+
+    // Uma mensagem não coube no buffer de saída e foi trocada por um ERROR
+    void overflowed() { overflows++; }
+
+    void reset();
+
+    const Histogram& histogram(Stage stage) const { return histograms[stage]; }
+    uint32_t missedDeadlines() const { return missed; }
+    uint32_t overflowedMessages() const { return overflows; }
+    uint32_t cpuMHz() const { return cyclesPerMicro; }
+
+    static const char* name(Stage stage);
+
+private:
+    Histogram histograms[STAGE_COUNT] = {};
+    uint32_t cyclesPerMicro = 240;
+    uint32_t missed = 0;
+    uint32_t overflows = 0;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "melody_sequencer.h"
+#include "output_pins.h"
+
+void MelodySequencer::begin(uint8_t pin) {
+    buzzerPin = pin;
+
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "melody";
+    esp_timer_create(&args, &timer);
+}
+
+void MelodySequencer::load(const MelodyNote* source, size_t length, bool repeat) {
+    stop();
+    count = length < MAX_NOTES ? length : MAX_NOTES;
+    memcpy(notes, source, count * sizeof(MelodyNote));
+    loop = repeat;
+}
+
+void MelodySequencer::play() {
+    stop();
+    if (count == 0) return;
+
+    current = 0;
+    deadline = esp_timer_get_time();
+    active = true;
+    startNote();
+}
+
+// Mesmo raciocínio do OutputWaveform::stop(): a tarefa do esp_timer não é
+// interrompida pela tarefa das missões no meio de um callback
+void MelodySequencer::stop() {
+    if (!active) return;
+    active = false;
+    esp_timer_stop(timer);
+    OutputPins::noTone(buzzerPin);
+}
+
+// Toca a nota atual e agenda o seu fim a partir do fim da anterior
+void MelodySequencer::startNote() {
+    const MelodyNote& note = notes[current];
+    if (note.frequency > 0) {
+        OutputPins::tone(buzzerPin, note.frequency);
+    } else {
+        OutputPins::noTone(buzzerPin);
+    }
+
+    deadline += note.duration * 1000LL;
+    int64_t wait = deadline - esp_timer_get_time();
+    esp_timer_start_once(timer, wait > 1 ? wait : 1);
+}
+
+// Roda na tarefa do esp_timer, no fim de cada nota
+void MelodySequencer::onTimer(void* arg) {
+    MelodySequencer& sequencer = *static_cast<MelodySequencer*>(arg);
+    if (!sequencer.active) return;
+
+    if (++sequencer.current >= sequencer.count) {
+        if (!sequencer.loop) {
+            sequencer.active = false;
+            OutputPins::noTone(sequencer.buzzerPin);
+            return;
+        }
+        sequencer.current = 0;
+    }
+    sequencer.startNote();
+}
+
+size_t MelodySequencer::unpack(const uint8_t* data, size_t length, MelodyNote* out, size_t capacity) {
+    if (length == 0 || length % NOTE_BYTES != 0 || length / NOTE_BYTES > capacity) return 0;
+
+    size_t total = length / NOTE_BYTES;
+    for (size_t i = 0; i < total; i++) {
+        const uint8_t* bytes = data + i * NOTE_BYTES;
+        out[i].frequency = (bytes[0] << 8) | bytes[1];
+        out[i].duration = (bytes[2] << 8) | bytes[3];
+        if (out[i].duration == 0) return 0;
+    }
+    return total;
+}
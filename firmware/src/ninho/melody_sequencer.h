@@ -0,0 +1,60 @@
+#ifndef MELODY_SEQUENCER_H
+#define MELODY_SEQUENCER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+
+// Uma nota da melodia
+struct MelodyNote {
+    uint16_t frequency;   // Hz (0 = pausa)
+    uint16_t duration;    // ms
+};
+
+// Toca uma lista de notas no buzzer sem custo para a tarefa das missões.
+// Cada nota começa num callback de um esp_timer de disparo único, rearmado
+// para o fim exato da nota (início + duração), então as durações não
+// dependem da carga do loop e não acumulam atraso ao longo da melodia.
+class MelodySequencer {
+public:
+    static const size_t MAX_NOTES = 64;
+
+    // Bytes por nota no formato binário do PLAY: Hz e ms, 16 bits big-endian
+    static const size_t NOTE_BYTES = 4;
+
+    void begin(uint8_t pin);
+
+    // Troca a melodia (para a que estiver tocando). Notas além de MAX_NOTES
+    // são ignoradas; loop = recomeça ao fim.
+    void load(const MelodyNote* notes, size_t count, bool loop);
+
+    // Toca desde a primeira nota
+    void play();
+
+    // Para e silencia o buzzer
+    void stop();
+
+    bool playing() const { return active; }
+
+    // Converte o formato binário do PLAY. Retorna o número de notas, ou 0 se
+    // o tamanho não fechar em notas, passar de capacity ou houver nota sem duração.
+    static size_t unpack(const uint8_t* data, size_t length, MelodyNote* notes, size_t capacity);
+
+private:
+    static void onTimer(void* arg);
+    void startNote();
+
+    uint8_t buzzerPin = 0;
+    esp_timer_handle_t timer = nullptr;
+
+    MelodyNote notes[MAX_NOTES];
+    size_t count = 0;
+    bool loop = false;
+
+    // Escrito pela tarefa das missões; o callback confere antes de agir
+    std::atomic<bool> active{false};
+    size_t current = 0;
+    int64_t deadline = 0;   // Fim da nota atual (esp_timer_get_time)
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "mission_fsm.h"
+#include "output_pins.h"
+
+void FsmMission::writeLow(FsmMission& m, unsigned long now, uint16_t param) {
+    m.output.stop();
+    OutputPins::write(m.output.pin(), LOW);
+}
+
+void FsmMission::writeHigh(FsmMission& m, unsigned long now, uint16_t param) {
+    m.output.stop();
+    OutputPins::write(m.output.pin(), HIGH);
+}
+
+// As trocas seguintes ficam com o esp_timer, sem trabalho no tick
+void FsmMission::startBlink(FsmMission& m, unsigned long now, uint16_t param) {
+    m.output.stop();
+    m.output.blink(param, HIGH);
+}
+
+// Uma entrada por FsmAction, na mesma ordem do enum
+const FsmMission::ActionHook FsmMission::ENTER_ACTIONS[FSM_ACTIONS] = { writeLow, writeHigh, startBlink };
+
+FsmMission::FsmMission(const FsmView& table, OutputWaveform& output) : table(table), output(output) {
+    for (uint8_t p = 0; p < table.paramCount; p++) {
+        values[p] = table.params[p].value;
+    }
+}
+
+void FsmMission::enter(unsigned long now) {
+    active = true;
+    goTo(0, now);
+}
+
+void FsmMission::goTo(uint8_t next, unsigned long now) {
+    state = next;
+    enteredAt = now;
+    const FsmState& entered = table.states[state];
+    uint16_t param = entered.param != FSM_NO_PARAM ? values[entered.param] : 0;
+    ENTER_ACTIONS[entered.action](*this, now, param);
+}
+
+void FsmMission::tick(unsigned long now, bool pressed) {
+    const FsmState* current = &table.states[state];
+
+    // O aperto tem prioridade sobre o tempo no estado
+    bool timedOut = current->timeout != FSM_NO_PARAM && now - enteredAt >= values[current->timeout];
+    uint8_t event = pressed ? FSM_PRESS : (timedOut ? FSM_TIMEOUT : FSM_NONE);
+
+    uint8_t next = current->next[event];
+    if (next != state) {
+        goTo(next, now);
+    }
+}
+
+void FsmMission::exit() {
+    active = false;
+    output.stop();
+    OutputPins::write(output.pin(), LOW);
+}
+
+int FsmMission::paramIndex(const char* name) const {
+    for (uint8_t p = 0; p < table.paramCount; p++) {
+        if (strcmp(name, table.params[p].name) == 0) return p;
+    }
+    return -1;
+}
+
+bool FsmMission::paramInRange(uint8_t index, long value) const {
+    return index < table.paramCount
+        && value >= table.params[index].min && value <= table.params[index].max;
+}
+
+// Um pisca em andamento passa ao período novo, contado da última troca
+void FsmMission::setParam(uint8_t index, uint16_t value) {
+    if (index >= table.paramCount) return;
+    values[index] = value;
+    if (!active) return;
+
+    const FsmState& current = table.states[state];
+    if (current.action == FSM_BLINK && current.param == index) {
+        output.blink(value, HIGH);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef MISSION_FSM_H
+#define MISSION_FSM_H
+
+#include <Arduino.h>
+#include "output_waveform.h"
+
+// Máquina de estados declarativa para missões com vários modos.
+// Os estados, as transições (aperto do botão ou tempo no estado) e a ação de
+// saída de cada estado ficam numa tabela constexpr (FsmTable); a cada tick o
+// executor (FsmMission) só consulta a tabela:
+//
+//   próximo = estados[atual].next[evento]
+//
+// Uma missão nova com modos é uma tabela nova, não uma cópia de código.
+// Cada missão tem o seu FsmMission (estado, temporizadores e parâmetros), e
+// os parâmetros podem ser trocados em tempo de execução (SET_PARAM).
+
+// Eventos, na ordem de FsmState::next. NONE (nada aconteceu) precisa levar
+// ao próprio estado.
+enum FsmEvent : uint8_t {
+    FSM_NONE,
+    FSM_PRESS,     // Aperto do botão neste tick
+    FSM_TIMEOUT,   // Passou o parâmetro "timeout" desde a entrada no estado
+    FSM_EVENTS
+};
+
+// Ação de saída do estado, aplicada à saída da missão (OutputWaveform)
+enum FsmAction : uint8_t {
+    FSM_OFF,       // Saída em LOW
+    FSM_ON,        // Saída em HIGH
+    FSM_BLINK,     // Acende ao entrar e inverte a cada "param" ms (esp_timer)
+    FSM_ACTIONS
+};
+
+const uint8_t FSM_NO_PARAM = 0xFF;
+const uint8_t FSM_MAX_PARAMS = 4;
+
+struct FsmState {
+    FsmAction action;
+    uint8_t param;     // Parâmetro da ação (período do FSM_BLINK) ou FSM_NO_PARAM
+    uint8_t timeout;   // Parâmetro do FSM_TIMEOUT ou FSM_NO_PARAM (nunca dispara)
+    uint8_t next[FSM_EVENTS];
+};
+
+// Parâmetro ajustável pelo SET_PARAM, com a sua faixa válida
+struct FsmParam {
+    const char* name;
+    uint16_t value;   // Valor padrão
+    uint16_t min;
+    uint16_t max;
+};
+
+// Visão sem template de uma tabela, usada pelo executor
+struct FsmView {
+    const FsmState* states;
+    uint8_t stateCount;
+    const FsmParam* params;
+    uint8_t paramCount;
+};
+
+template <uint8_t STATES, uint8_t PARAMS>
+struct FsmTable {
+    static_assert(STATES > 0 && STATES < FSM_NO_PARAM, "Numero de estados invalido");
+    static_assert(PARAMS <= FSM_MAX_PARAMS, "Parametros demais");
+
+    FsmState states[STATES];
+    FsmParam params[PARAMS];
+
+    constexpr FsmView view() const { return { states, STATES, params, PARAMS }; }
+
+    // Confere a tabela em tempo de compilação (usar com static_assert)
+    constexpr bool valid() const {
+        for (uint8_t s = 0; s < STATES; s++) {
+            const FsmState& state = states[s];
+            if (state.action >= FSM_ACTIONS || state.next[FSM_NONE] != s) return false;
+            if (state.action == FSM_BLINK && state.param >= PARAMS) return false;
+            if (state.timeout != FSM_NO_PARAM && state.timeout >= PARAMS) return false;
+            for (uint8_t e = 0; e < FSM_EVENTS; e++) {
+                if (state.next[e] >= STATES) return false;
+            }
+        }
+        for (uint8_t p = 0; p < PARAMS; p++) {
+            if (params[p].min > params[p].value || params[p].value > params[p].max) return false;
+        }
+        return true;
+    }
+};
+
+class FsmMission {
+public:
+    FsmMission(const FsmView& table, OutputWaveform& output);
+
+    // Começa no estado 0 (os parâmetros trocados continuam valendo)
+    void enter(unsigned long now);
+    void tick(unsigned long now, bool pressed);
+    void exit();
+
+    // Índice do parâmetro ou -1 (chamado pela tarefa de comunicação: só lê
+    // a tabela constante)
+    int paramIndex(const char* name) const;
+    bool paramInRange(uint8_t index, long value) const;
+
+    // Chamado pela tarefa das missões (MissionCommand::SET_PARAM). Fora da
+    // missão ativa só guarda o valor: a saída pode ser de outra missão.
+    void setParam(uint8_t index, uint16_t value);
+
+    uint8_t currentState() const { return state; }
+
+private:
+    void goTo(uint8_t next, unsigned long now);
+
+    // Ações indexadas por FsmAction, aplicadas ao entrar no estado (as
+    // trocas do pisca ficam com o OutputWaveform, sem trabalho no tick)
+    typedef void (*ActionHook)(FsmMission& m, unsigned long now, uint16_t param);
+    static const ActionHook ENTER_ACTIONS[FSM_ACTIONS];
+
+    static void writeLow(FsmMission& m, unsigned long now, uint16_t param);
+    static void writeHigh(FsmMission& m, unsigned long now, uint16_t param);
+    static void startBlink(FsmMission& m, unsigned long now, uint16_t param);
+
+    FsmView table;
+    OutputWaveform& output;
+    uint16_t values[FSM_MAX_PARAMS];
+
+    uint8_t state = 0;
+    unsigned long enteredAt = 0;
+    bool active = false;  // Entre enter() e exit()
+};
+
+#endif
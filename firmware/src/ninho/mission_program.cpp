@@ -0,0 +1,187 @@
+#include "mission_program.h"
+#include "hardware_map.h"
+#include "output_pins.h"
+
+constexpr uint8_t MissionProgram::OPERANDS[MissionProgram::OP_COUNT];
+
+static_assert(sizeof(MissionProgram::OPERANDS) == MissionProgram::OP_COUNT,
+              "Toda MissionProgram::Op precisa do seu numero de operandos");
+
+// Tamanho do cabeçalho até o início do código
+static size_t headerSize(uint8_t states, uint8_t notes) {
+    return 3 + 2 * notes + 2 * states;
+}
+
+MissionProgram::MissionProgram(OutputWaveform* const (&outputs)[OUTPUTS]) {
+    for (uint8_t i = 0; i < OUTPUTS; i++) this->outputs[i] = outputs[i];
+}
+
+bool MissionProgram::validate(const uint8_t* data, size_t length) {
+    if (length < 3 || length > MAX_SIZE || data[0] != VERSION) return false;
+
+    uint8_t states = data[1];
+    uint8_t notes = data[2];
+    if (states == 0 || states > MAX_STATES || notes > MAX_NOTES) return false;
+
+    size_t start = headerSize(states, notes);
+    if (start >= length) return false;
+    size_t codeLength = length - start;
+    const uint8_t* code = data + start;
+
+    // Marca o início de cada instrução: estados e saltos só podem cair nelas
+    bool boundary[MAX_SIZE] = {};
+    size_t at = 0;
+    uint8_t last = END;
+    while (at < codeLength) {
+        uint8_t op = code[at];
+        if (op >= OP_COUNT || at + 1 + OPERANDS[op] > codeLength) return false;
+        boundary[at] = true;
+
+        const uint8_t* operand = code + at + 1;
+        switch (op) {
+            case SET_OUT:
+            case TOGGLE_OUT:
+            case MIRROR_BUTTON:
+            case PWM_POT:
+            case FADE:
+                if (operand[0] >= OUTPUTS) return false;
+                break;
+            case BLINK:
+                if (operand[0] >= OUTPUTS || (operand[1] == 0 && operand[2] == 0)) return false;
+                break;
+            case NEXT_NOTE:
+                if (notes == 0) return false;
+                break;
+            case EVERY:
+                if (operand[0] >= TIMERS) return false;
+                break;
+            case GOTO:
+                if (operand[0] >= states) return false;
+                break;
+            default:
+                break;
+        }
+
+        last = op;
+        at += 1 + OPERANDS[op];
+    }
+
+    // Todo caminho termina: o código acaba em END ou GOTO
+    if (last != END && last != GOTO) return false;
+
+    for (uint8_t s = 0; s < states; s++) {
+        size_t entry = (data[3 + 2 * notes + 2 * s] << 8) | data[4 + 2 * notes + 2 * s];
+        if (entry >= codeLength || !boundary[entry]) return false;
+    }
+
+    // Saltos para frente, até o início de uma instrução
+    for (at = 0; at < codeLength; at += 1 + OPERANDS[code[at]]) {
+        uint8_t op = code[at];
+        if (op != IF_PRESSED && op != IF_BUTTON) continue;
+        size_t next = at + 1 + OPERANDS[op];
+        size_t target = next + code[next - 1];
+        if (target >= codeLength || !boundary[target]) return false;
+    }
+
+    return true;
+}
+
+void MissionProgram::assign(const uint8_t* data, size_t length) {
+    memcpy(program, data, length);
+    size = length;
+    code = length > 0 ? headerSize(program[1], program[2]) : 0;
+}
+
+void MissionProgram::enter(unsigned long now) {
+    note = 0;
+    goTo(0, now);
+}
+
+void MissionProgram::goTo(uint8_t next, unsigned long now) {
+    state = next;
+    for (uint8_t t = 0; t < TIMERS; t++) timers[t] = now;
+}
+
+void MissionProgram::tick(unsigned long now, const Inputs& in) {
+    if (size == 0) return;
+
+    uint8_t notes = program[2];
+    size_t at = code + read16(3 + 2 * notes + 2 * state);
+
+    for (;;) {
+        uint8_t op = program[at];
+        const uint8_t* operand = program + at + 1;
+        at += 1 + OPERANDS[op];
+
+        switch (op) {
+            case END:
+                return;
+            case SET_OUT:
+                outputs[operand[0]]->stop();
+                OutputPins::write(outputs[operand[0]]->pin(), operand[1] ? HIGH : LOW);
+                break;
+            case TOGGLE_OUT: {
+                outputs[operand[0]]->stop();
+                uint8_t pin = outputs[operand[0]]->pin();
+                OutputPins::write(pin, digitalRead(pin) ? LOW : HIGH);
+                break;
+            }
+            case MIRROR_BUTTON:
+                outputs[operand[0]]->stop();
+                OutputPins::write(outputs[operand[0]]->pin(), in.button);
+                break;
+            case PWM_POT:
+                outputs[operand[0]]->write(map(in.pot, 0, 4095, 0, 255));
+                pwmOutputs |= 1 << operand[0];
+                break;
+            case TONE:
+                OutputPins::tone(PIN_BUZZER, (operand[0] << 8) | operand[1], (operand[2] << 8) | operand[3]);
+                break;
+            case NO_TONE:
+                OutputPins::noTone(PIN_BUZZER);
+                break;
+            case NEXT_NOTE:
+                OutputPins::tone(PIN_BUZZER, read16(3 + 2 * note), (operand[0] << 8) | operand[1]);
+                if (++note >= notes) note = 0;
+                break;
+            case EVERY: {
+                unsigned long& timer = timers[operand[0]];
+                if (now - timer < (unsigned long)((operand[1] << 8) | operand[2])) return;
+                timer = now;
+                break;
+            }
+            case IF_PRESSED:
+                if (!in.pressed) at += operand[0];
+                break;
+            case IF_BUTTON:
+                if (in.button != (operand[0] ? HIGH : LOW)) at += operand[1];
+                break;
+            case GOTO:
+                goTo(operand[0], now);
+                return;
+            case BLINK:
+                outputs[operand[0]]->blink((operand[1] << 8) | operand[2], HIGH);
+                break;
+            case FADE:
+                outputs[operand[0]]->fade(operand[1], (operand[2] << 8) | operand[3]);
+                pwmOutputs |= 1 << operand[0];
+                break;
+        }
+    }
+}
+
+// As saídas digitais apagam juntas, numa única escrita no GPIO
+void MissionProgram::exit() {
+    uint32_t off = 0;
+    for (uint8_t i = 0; i < OUTPUTS; i++) {
+        outputs[i]->stop();
+        if (pwmOutputs & (1 << i)) {
+            outputs[i]->write(0);
+        } else {
+            off |= OutputPins::mask(outputs[i]->pin());
+        }
+    }
+    OutputPins::apply(0, off);
+    pwmOutputs = 0;
+    OutputPins::noTone(PIN_BUZZER);
+}
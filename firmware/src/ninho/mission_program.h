@@ -0,0 +1,100 @@
+#ifndef MISSION_PROGRAM_H
+#define MISSION_PROGRAM_H
+
+#include <Arduino.h>
+#include "output_waveform.h"
+
+// Missão enviada pelo host em bytecode (LOAD_MISSION) e executada pela
+// missão CUSTOM, sem regravar o firmware.
+//
+// Formato (números de 16 bits em big-endian):
+//   [0]  versão (VERSION)
+//   [1]  número de estados (1 a MAX_STATES)
+//   [2]  número de notas (0 a MAX_NOTES)
+//   notas: 2 bytes por nota (Hz), usadas por NEXT_NOTE
+//   estados: 2 bytes por estado, início do seu código (relativo ao código)
+//   código: instruções (Op + operandos)
+//
+// A cada tick o interpretador roda o código do estado atual desde o início
+// até END ou GOTO. Só existem saltos para frente, então um tick executa no
+// máximo uma vez cada instrução e nunca trava a tarefa das missões.
+//
+// BLINK e FADE entregam a saída ao OutputWaveform (esp_timer), que segue
+// sozinho até outra instrução escrever na mesma saída; repeti-las a cada
+// tick não as reinicia.
+class MissionProgram {
+public:
+    static const uint8_t VERSION = 1;
+    static const size_t MAX_SIZE = 512;
+    static const uint8_t MAX_STATES = 16;
+    static const uint8_t MAX_NOTES = 32;
+    static const uint8_t TIMERS = 4;
+
+    // Saídas endereçáveis pelo programa, na ordem do construtor
+    // (0 = PIN_LED, 1 = PIN_LED_2)
+    static const uint8_t OUTPUTS = 2;
+
+    // Instruções, com os operandos (1 byte cada, "16" = 2 bytes)
+    enum Op : uint8_t {
+        END,            //                 Termina o tick
+        SET_OUT,        // saída, nível    digitalWrite()
+        TOGGLE_OUT,     // saída           Inverte a saída
+        MIRROR_BUTTON,  // saída           Saída acompanha o botão
+        PWM_POT,        // saída           Brilho proporcional ao potenciômetro
+        TONE,           // hz16, ms16      tone() no buzzer
+        NO_TONE,        //                 noTone()
+        NEXT_NOTE,      // ms16            Toca a próxima nota da tabela (em ciclo)
+        EVERY,          // timer, ms16     Temporizador não venceu: termina o tick;
+                        //                 venceu: rearma e segue
+        IF_PRESSED,     // salto           Sem aperto neste tick: pula "salto" bytes
+        IF_BUTTON,      // nível, salto    Botão diferente de "nível": pula
+        GOTO,           // estado          Troca de estado e termina o tick
+        BLINK,          // saída, ms16     Pisca a saída (acende agora)
+        FADE,           // saída, duty, ms16  Leva o duty (0 a 255) ao valor em ms16
+        OP_COUNT
+    };
+
+    // Bytes de operandos de cada Op, na mesma ordem do enum
+    static constexpr uint8_t OPERANDS[OP_COUNT] = { 0, 2, 1, 1, 1, 4, 0, 2, 3, 1, 2, 1, 3, 4 };
+
+    // Entradas lidas pela tarefa das missões no tick
+    struct Inputs {
+        bool pressed;   // Houve um aperto (já consumido)
+        int button;     // Nível filtrado (HIGH/LOW)
+        int pot;        // 0 a 4095
+    };
+
+    explicit MissionProgram(OutputWaveform* const (&outputs)[OUTPUTS]);
+
+    // Confere a estrutura inteira (cabeçalho, instruções, operandos e saltos);
+    // um programa aprovado aqui não lê nada fora de si mesmo
+    static bool validate(const uint8_t* data, size_t length);
+
+    // Copia um programa já validado (length 0 descarta o atual)
+    void assign(const uint8_t* data, size_t length);
+    bool loaded() const { return size > 0; }
+
+    // Começa no estado 0 com os temporizadores zerados
+    void enter(unsigned long now);
+    void tick(unsigned long now, const Inputs& in);
+
+    // Desliga as saídas e o buzzer
+    void exit();
+
+private:
+    uint16_t read16(size_t at) const { return (program[at] << 8) | program[at + 1]; }
+    void goTo(uint8_t next, unsigned long now);
+
+    OutputWaveform* outputs[OUTPUTS];
+
+    uint8_t program[MAX_SIZE];
+    size_t size = 0;
+    size_t code = 0;   // Início do código
+
+    uint8_t state = 0;
+    uint8_t note = 0;
+    uint8_t pwmOutputs = 0;   // Um bit por saída que já recebeu PWM_POT ou FADE
+    unsigned long timers[TIMERS] = {};
+};
+
+#endif
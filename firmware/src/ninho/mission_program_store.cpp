@@ -0,0 +1,45 @@
+#include "mission_program_store.h"
+#include "base64.h"
+
+void MissionProgramStore::begin() {
+    preferences.begin("ninho", false);
+
+    size_t length = preferences.getBytesLength("mission");
+    if (length == 0 || length > sizeof(program)) return;
+    if (preferences.getBytes("mission", program, length) != length) return;
+
+    // Um programa salvo por outra versão do firmware é ignorado
+    if (MissionProgram::validate(program, length)) {
+        programLength = length;
+    }
+}
+
+MissionProgramStore::Result MissionProgramStore::receive(long offset, long size, const char* data) {
+    if (offset == 0) {
+        if (size < 1 || size > (long)sizeof(upload)) return INVALID;
+        uploadSize = size;
+        received = 0;
+    }
+
+    // Só aceita o pedaço seguinte do envio em andamento
+    if (uploadSize == 0 || offset != (long)received || size != (long)uploadSize) {
+        uploadSize = 0;
+        return INVALID;
+    }
+
+    long count = Base64::decode(data, upload + received, uploadSize - received);
+    if (count <= 0) {
+        uploadSize = 0;
+        return INVALID;
+    }
+    received += count;
+    if (received < uploadSize) return PARTIAL;
+
+    uploadSize = 0;
+    if (!MissionProgram::validate(upload, received)) return INVALID;
+
+    memcpy(program, upload, received);
+    programLength = received;
+    preferences.putBytes("mission", program, programLength);
+    return COMPLETE;
+}
@@ -0,0 +1,42 @@
+#ifndef MISSION_PROGRAM_STORE_H
+#define MISSION_PROGRAM_STORE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "mission_program.h"
+
+// Recebe o programa da missão CUSTOM em pedaços (LOAD_MISSION), confere e
+// guarda na NVS, para que ele sobreviva a um reinício.
+// Usado apenas pela tarefa de comunicação; a tarefa das missões copia o
+// programa pronto para o seu MissionProgram.
+class MissionProgramStore {
+public:
+    enum Result {
+        PARTIAL,    // Pedaço aceito, faltam outros
+        COMPLETE,   // Programa inteiro recebido, válido e gravado
+        INVALID     // Pedaço fora de ordem, base64 ou programa inválido
+    };
+
+    // Lê o programa salvo (se houver e for válido)
+    void begin();
+
+    // offset: posição do pedaço no programa (0 começa um envio novo)
+    // size: tamanho total do programa; data: o pedaço em base64
+    Result receive(long offset, long size, const char* data);
+
+    // Último programa completo (length 0 se nenhum)
+    const uint8_t* data() const { return program; }
+    size_t length() const { return programLength; }
+
+private:
+    Preferences preferences;
+
+    // O programa completo fica em "program"; o envio em andamento, em "upload"
+    uint8_t program[MissionProgram::MAX_SIZE];
+    size_t programLength = 0;
+    uint8_t upload[MissionProgram::MAX_SIZE];
+    size_t uploadSize = 0;
+    size_t received = 0;
+};
+
+#endif
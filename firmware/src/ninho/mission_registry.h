@@ -0,0 +1,133 @@
+#ifndef MISSION_REGISTRY_H
+#define MISSION_REGISTRY_H
+
+#include <Arduino.h>
+
+// Identificadores de todas as missões suportadas pelo firmware.
+// A ordem aqui define o índice da missão na tabela MISSIONS (ninho.ino).
+enum class MissionId : uint8_t {
+    IDLE = 0,
+    INTRO,
+    MISSION_1_ON,
+    MISSION_1_BLINK,
+    MISSION_2_LED_1K,
+    MISSION_2_DOORBELL,
+    MISSION_2_TOGGLE,
+    MISSION_3_BUZZER,
+    MISSION_3_READ,
+    MISSION_3_PWM,
+    MISSION_4_STATE_MACHINE,
+    MISSION_5_FINAL,
+    CUSTOM,
+    COUNT
+};
+
+// Uma missão é um objeto com ganchos de entrada, execução e saída.
+// enter() roda uma vez ao ativar a missão, tick() a cada passada do loop
+// e exit() uma vez antes de trocar para outra missão.
+struct Mission {
+    MissionId id;
+    void (*enter)();
+    void (*tick)(unsigned long now);
+    void (*exit)();
+};
+
+namespace MissionRegistry {
+
+constexpr size_t COUNT = static_cast<size_t>(MissionId::COUNT);
+
+// Nomes usados no protocolo (campo "missionId"), na mesma ordem do enum
+constexpr const char* NAMES[COUNT] = {
+    "IDLE",
+    "INTRO",
+    "MISSION_1_ON",
+    "MISSION_1_BLINK",
+    "MISSION_2_LED_1K",
+    "MISSION_2_DOORBELL",
+    "MISSION_2_TOGGLE",
+    "MISSION_3_BUZZER",
+    "MISSION_3_READ",
+    "MISSION_3_PWM",
+    "MISSION_4_STATE_MACHINE",
+    "MISSION_5_FINAL",
+    "CUSTOM",
+};
+
+// Tabela de hash com potência de 2 posições e folga de ~2x sobre o número de missões
+constexpr size_t TABLE_SIZE = 32;
+constexpr uint8_t EMPTY_SLOT = 0xFF;
+static_assert(TABLE_SIZE >= COUNT && (TABLE_SIZE & (TABLE_SIZE - 1)) == 0,
+              "TABLE_SIZE deve ser potencia de 2 e maior que o numero de missoes");
+
+constexpr size_t length(const char* s) {
+    size_t n = 0;
+    while (s[n] != '\0') n++;
+    return n;
+}
+
+// FNV-1a com semente: barato e suficiente para poucas chaves curtas
+constexpr uint32_t hash(const char* s, size_t len, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (size_t i = 0; i < len; i++) {
+        h ^= static_cast<uint8_t>(s[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr size_t slotOf(const char* s, size_t len, uint32_t seed) {
+    return hash(s, len, seed) & (TABLE_SIZE - 1);
+}
+
+// Uma semente é "perfeita" se nenhum par de nomes cai na mesma posição
+constexpr bool isPerfect(uint32_t seed) {
+    bool used[TABLE_SIZE] = {};
+    for (size_t i = 0; i < COUNT; i++) {
+        size_t slot = slotOf(NAMES[i], length(NAMES[i]), seed);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t findSeed() {
+    uint32_t seed = 0;
+    while (!isPerfect(seed)) seed++;
+    return seed;
+}
+
+// Procurada pelo compilador: nenhum custo em tempo de execução
+constexpr uint32_t SEED = findSeed();
+
+struct Table {
+    uint8_t slots[TABLE_SIZE];
+};
+
+constexpr Table buildTable() {
+    Table t = {};
+    for (size_t i = 0; i < TABLE_SIZE; i++) t.slots[i] = EMPTY_SLOT;
+    for (size_t i = 0; i < COUNT; i++) {
+        t.slots[slotOf(NAMES[i], length(NAMES[i]), SEED)] = static_cast<uint8_t>(i);
+    }
+    return t;
+}
+
+constexpr Table TABLE = buildTable();
+
+constexpr const char* name(MissionId id) {
+    return NAMES[static_cast<size_t>(id)];
+}
+
+// Resolve o nome recebido no SET_MISSION: um hash, um acesso à tabela e
+// uma única comparação para rejeitar nomes desconhecidos.
+inline bool lookup(const char* s, size_t len, MissionId& out) {
+    uint8_t index = TABLE.slots[slotOf(s, len, SEED)];
+    if (index == EMPTY_SLOT) return false;
+    if (length(NAMES[index]) != len || memcmp(NAMES[index], s, len) != 0) return false;
+    out = static_cast<MissionId>(index);
+    return true;
+}
+
+}  // namespace MissionRegistry
+
+#endif
@@ -7,9 +7,21 @@
  * Ele recebe comandos via Serial (JSON) e executa a lógica correspondente.
  *
  * Comunicação:
- * - Protocolo: JSON via Serial
+ * - Protocolo: JSON via Serial (ou MessagePack, opcionalmente em quadros
+ *   COBS com CRC-16: SET_FORMAT)
  * - Baud Rate: 115200
- * - Comandos: SET_ID, SET_MISSION, GET_STATUS
+ * - Comandos: SET_ID, SET_MISSION, GET_STATUS, GET_VERSION, SET_FORMAT,
+ *   SET_TELEMETRY, SET_CAPTURE, GET_METRICS, SET_BAUD, PING, LOAD_MISSION,
+ *   SET_PARAM, PLAY
+ *
+ * Tarefas (os dois núcleos do ESP32):
+ * - Missões: tarefa de alta prioridade, presa a um núcleo, executa a missão
+ *   ativa a cada 1ms (LEDs, botão, potenciômetro, buzzer)
+ * - Comunicação: o próprio loop(), no outro núcleo, cuida da Serial (JSON),
+ *   da NVS e da telemetria. Entre uma volta e outra ele dorme até o próximo
+ *   prazo (deadline_scheduler.h) ou até chegar um byte na Serial.
+ * As duas conversam apenas por filas sem trava (spsc_queue.h), então uma
+ * escrita lenta na Serial nunca atrasa o LED ou o botão.
  *
  * Hardware utilizado:
  * - LED no pino GPIO 2
@@ -18,8 +30,24 @@
  */
 
 #include <Arduino.h>
+#include "base64.h"
+#include "button_input.h"
+#include "command_reader.h"
+#include "deadline_scheduler.h"
 #include "hardware_map.h"
+#include "loop_profiler.h"
+#include "melody_sequencer.h"
+#include "mission_fsm.h"
+#include "mission_program.h"
+#include "mission_program_store.h"
+#include "mission_registry.h"
+#include "output_pins.h"
+#include "output_waveform.h"
+#include "pot_sampler.h"
 #include "protocol.h"
+#include "rtttl.h"
+#include "spsc_queue.h"
+#include "task_messages.h"
 #include "user_id_store.h"
 #include "version.h"
 
@@ -27,369 +55,1284 @@
 UserIdStore userStore;
 Protocol protocol;
 
+// Monta as linhas de comando recebidas pela Serial sem bloquear o loop
+CommandReader commandReader;
+
+// Tempo gasto em cada etapa do loop() e da tarefa das missões (GET_METRICS)
+LoopProfiler profiler;
+
+// Buffer circular de envio do driver da UART: o quadro entregue pelo
+// Protocol fica nele enquanto a UART transmite, e o loop() segue montando o
+// próximo. Sem ele (padrão 0), cada escrita espera a UART esvaziar.
+const size_t SERIAL_TX_BUFFER = 2048;
+
+// ========================================
+// TAREFAS E FILAS
+// ========================================
+
+// A tarefa das missões roda a cada 1ms (1 tick do FreeRTOS), com prioridade
+// acima do loop() e no núcleo que o loop() não usa
+const TickType_t MISSION_PERIOD = pdMS_TO_TICKS(1);
+const UBaseType_t MISSION_TASK_PRIORITY = 5;
+const uint32_t MISSION_TASK_STACK = 4096;
+TaskHandle_t missionTaskHandle = nullptr;
+
+// Tarefa do loop(): acordada pela Serial e pela tarefa das missões
+TaskHandle_t commTaskHandle = nullptr;
+
+// Comunicação → missões (ex: troca de missão)
+SpscQueue<MissionCommand, 8> missionCommands;
+
+// Missões → comunicação (estado das entradas/saídas a cada tick)
+const size_t SNAPSHOT_QUEUE_SIZE = 16;
+SpscQueue<SensorSnapshot, SNAPSHOT_QUEUE_SIZE> sensorSnapshots;
+
+// Último estado publicado pela tarefa das missões (só ela usa)
+SensorSnapshot publishedSnapshot = {};
+
+// Prazos da tarefa de comunicação: o loop() dorme até o mais próximo.
+// Nunca dorme mais que LOOP_MAX_SLEEP: com a fila de leituras cheia, a
+// tarefa das missões descarta as novas, então o loop() precisa esvaziá-la
+// antes que 16 ticks se passem (a da captura, com 256, folga ainda mais).
+DeadlineScheduler scheduler;
+const unsigned long LOOP_MAX_SLEEP = 10;
+static_assert(pdMS_TO_TICKS(LOOP_MAX_SLEEP) < SNAPSHOT_QUEUE_SIZE * MISSION_PERIOD,
+              "LOOP_MAX_SLEEP deve ser menor que o tempo para encher a fila de leituras");
+
+// Última leitura recebida da tarefa das missões (usada na telemetria)
+SensorSnapshot latestSnapshot = {};
+
+// Missão do último SET_MISSION aceito. A tarefa das missões só troca no
+// próximo tick e o latestSnapshot só mostra a troca depois disso; um
+// SET_PARAM logo em seguida (ou na mesma rajada) já vale para a missão nova
+MissionId requestedMission = MissionId::IDLE;
+
+// Última leitura enviada ao host (base da telemetria por mudança)
+SensorSnapshot lastSentSnapshot = {};
+
+// Captura em alta taxa (SET_CAPTURE): a tarefa das missões amostra as
+// entradas e saídas a cada "capturePeriod" ticks (1 tick = 1ms) e a tarefa
+// de comunicação junta as amostras em lotes antes de enviar
+SpscQueue<CaptureSample, 256> captureSamples;
+uint32_t capturePeriod = 0;       // Tarefa das missões (0 = desligada)
+uint32_t captureCountdown = 0;    // Tarefa das missões
+CaptureSample captureBatch[Protocol::MAX_SAMPLES];  // Tarefa de comunicação
+size_t captureBatchSize = 16;     // Tarefa de comunicação
+size_t captureCount = 0;          // Tarefa de comunicação
+
+// Formas de onda dos LEDs: pisca e fade rodam em callbacks do esp_timer,
+// sem trabalho a cada tick e sem acumular atraso (output_waveform.h)
+OutputWaveform ledWave;
+OutputWaveform led2Wave;
+
+// Missão CUSTOM (LOAD_MISSION): a tarefa de comunicação recebe e grava o
+// programa; a tarefa das missões o copia para o seu interpretador quando
+// recebe LOAD_PROGRAM e só então libera a loja para um envio novo
+OutputWaveform* const PROGRAM_OUTPUTS[MissionProgram::OUTPUTS] = { &ledWave, &led2Wave };
+MissionProgramStore programStore;                 // Tarefa de comunicação
+MissionProgram customProgram(PROGRAM_OUTPUTS);    // Tarefa das missões
+std::atomic<bool> programPending{false};
+
+// Melodia da Missão 3 (PLAY): mesma passagem do LOAD_MISSION, a tarefa de
+// comunicação preenche melodyUpload e a tarefa das missões a copia para o
+// sequenciador ao receber LOAD_MELODY
+MelodyNote melodyUpload[MelodySequencer::MAX_NOTES];
+size_t melodyUploadCount = 0;
+std::atomic<bool> melodyPending{false};
+
 // ========================================
 // VARIÁVEIS GLOBAIS
 // ========================================
 
-// Missão atual sendo executada (ex: "MISSION_1_BLINK", "MISSION_2_TOGGLE")
-String currentMission = "IDLE";
+// Missão atual sendo executada (aponta para uma entrada da tabela MISSIONS)
+const Mission* currentMission = nullptr;
+
+// Troca a missão ativa (definida junto com a tabela de missões, mais abaixo)
+void switchMission(MissionId id);
+
+// Corpo da tarefa das missões (definida mais abaixo)
+void missionTask(void* parameter);
+
+// Prazos da tarefa de comunicação (definidos mais abaixo)
+void sendTelemetry(unsigned long now);
+void checkBaud(unsigned long now);
+
+// Acorda o loop() antes do próximo prazo (byte novo na Serial, mudança
+// vista pela tarefa das missões). Se ele estiver acordado, a notificação
+// fica guardada e a próxima espera termina na hora: nada se perde.
+void wakeCommTask() {
+    if (commTaskHandle) xTaskNotifyGive(commTaskHandle);
+}
+
+// Controle de telemetria (ajustável com SET_TELEMETRY)
+// - Periódica: envia um quadro a cada "interval" ms
+// - Por mudança: envia só quando LED, botão, missão ou potenciômetro (além da
+//   zona morta) mudam, no máximo um quadro a cada "interval" ms, e um
+//   "heartbeat" a cada "heartbeat" ms quando nada muda
+struct TelemetryConfig {
+    unsigned long interval = 500;   // Envia telemetria a cada 500ms
+    bool onChange = false;
+    uint16_t deadband = 16;         // Variação mínima do potenciômetro (0 a 4095)
+    unsigned long heartbeat = 5000;
+    bool extended = false;          // potMin/potMax/potMean e "tick" nos quadros
+};
+
+const unsigned long TELEMETRY_MIN_INTERVAL = 1;
+const unsigned long TELEMETRY_MAX_INTERVAL = 60000;
 
-// Controle de telemetria periódica
+TelemetryConfig telemetryConfig;
 unsigned long lastTelemetry = 0;
-const unsigned long TELEMETRY_INTERVAL = 500; // Envia telemetria a cada 500ms
+uint8_t telemetryTimer = 0;
+
+// Velocidade da Serial (SET_BAUD). A placa sempre liga em 115200; uma
+// velocidade nova só fica se o host confirmar com PING nela a tempo, e volta
+// para 115200 se o host sumir (ex: página recarregada, que reabre em 115200)
+const uint32_t SERIAL_DEFAULT_BAUD = 115200;
+const uint32_t SERIAL_BAUD_RATES[] = { 2000000, 1500000, 1000000, 921600, 500000, 460800, 230400, 115200 };
+const unsigned long BAUD_CONFIRM_TIMEOUT = 1000;  // Espera pelo PING na nova velocidade
+const unsigned long BAUD_IDLE_TIMEOUT = 5000;     // Fora do link padrão, sem comandos válidos
+uint32_t serialBaud = SERIAL_DEFAULT_BAUD;
+bool baudConfirming = false;
+unsigned long baudChangedAt = 0;
+unsigned long lastValidCommand = 0;
+uint8_t baudTimer = 0;
 
 // ========================================
 // VARIÁVEIS DE ESTADO DAS MISSÕES
 // ========================================
 
-// Para missões com LED piscando: guarda o momento da última mudança
-unsigned long lastBlink = 0;
-
-// Estado atual do LED (true = aceso, false = apagado)
-bool ledState = false;
+// Botão lido por interrupção (bordas com instante e debounce)
+ButtonInput button;
 
-// Leitura atual do botão (HIGH ou LOW)
-int buttonState = 0;
+// Potenciômetro amostrado continuamente pelo ADC (DMA), com média e janela
+PotSampler pot;
 
-// Leitura anterior do botão (para detectar mudanças)
-int lastButtonState = 0;
+// Entradas do tick atual (botão e potenciômetro), lidas uma única vez no
+// começo do tick: a missão, a telemetria e a captura usam esta leitura
+InputSnapshot inputs = {};
 
-// Valor lido do potenciômetro (0 a 4095)
-int potValue = 0;
+// Apertos deste tick ainda não consumidos pela missão
+uint8_t buttonPresses = 0;
 
 // Estado de alternância (toggle) para Missão 2
 // Quando o botão é pressionado, esse estado inverte (liga/desliga)
 bool toggleState = false;
 
-// Variáveis para o Buzzer (Missão 3)
-int melody[] = {262, 294, 330, 349, 392, 440, 494, 523}; // C, D, E, F, G, A, B, C
-int noteDuration = 500;
-unsigned long lastNoteTime = 0;
-int currentNote = 0;
+// Buzzer (Missão 3): as notas trocam em callbacks do esp_timer, com
+// duração exata e sem custo para o tick da missão
+MelodySequencer buzzerMelody;
+
+// Melodia padrão: escala de Dó, 500ms por nota, em ciclo (troca com PLAY)
+const MelodyNote DEFAULT_MELODY[] = {
+    {262, 500}, {294, 500}, {330, 500}, {349, 500},  // C, D, E, F
+    {392, 500}, {440, 500}, {494, 500}, {523, 500},  // G, A, B, C
+};
 
 // ========================================
-// MÁQUINA DE ESTADOS (Missões 4 e 5)
+// BOTÃO
 // ========================================
 
-// Modo atual: 0 = Desligado, 1 = Aceso, 2 = Piscando
-int mode = 0;
-
 // Debounce: evita múltiplas leituras de um único aperto de botão
-unsigned long lastDebounceTime = 0;
-const unsigned long debounceDelay = 50; // 50ms de debounce
+const uint32_t DEBOUNCE_MICROS = 50000; // 50ms de debounce
 
 // ========================================
 // SETUP - Executado UMA VEZ ao ligar
 // ========================================
 void setup() {
     // Inicia comunicação serial para receber comandos e enviar telemetria
-    Serial.begin(115200);
+    // (o buffer de envio precisa ser definido antes do begin)
+    Serial.setTxBufferSize(SERIAL_TX_BUFFER);
+    Serial.begin(SERIAL_DEFAULT_BAUD);
+
+    // O loop() dorme entre os prazos; um byte novo na Serial o acorda na hora
+    commTaskHandle = xTaskGetCurrentTaskHandle();
+    Serial.onReceive(wakeCommTask);
+    telemetryTimer = scheduler.add(sendTelemetry);
+    baudTimer = scheduler.add(checkBaud);
+
+    profiler.begin();
+    protocol.setProfiler(&profiler);
 
     // Configura os pinos conforme o hardware
     pinMode(PIN_LED, OUTPUT);
     pinMode(PIN_LED_2, OUTPUT);
     pinMode(PIN_BUZZER, OUTPUT);
+    ledWave.begin(PIN_LED);
+    led2Wave.begin(PIN_LED_2);
+    buzzerMelody.begin(PIN_BUZZER);
+    buzzerMelody.load(DEFAULT_MELODY, sizeof(DEFAULT_MELODY) / sizeof(DEFAULT_MELODY[0]), true);
 
     // Botão configurado como INPUT (assumimos resistor pull-down externo)
     // Se usar pull-up interno (INPUT_PULLUP), a lógica HIGH/LOW seria invertida
     pinMode(PIN_BUTTON, INPUT);
 
+    // Cada borda do botão gera uma interrupção com o instante exato
+    button.begin(PIN_BUTTON, DEBOUNCE_MICROS);
+
+    // O ADC passa a amostrar o potenciômetro sozinho, em segundo plano
+    pot.begin(PIN_POT);
+
     // Inicializa o armazenamento persistente de userId (EEPROM)
     userStore.begin();
+
+    // Programa da missão CUSTOM gravado por um LOAD_MISSION anterior
+    // (a tarefa das missões ainda não existe: a cópia direta é segura)
+    programStore.begin();
+    customProgram.assign(programStore.data(), programStore.length());
+
+    // Começa sem missão ativa
+    switchMission(MissionId::IDLE);
+
+    // Inicia a tarefa das missões no outro núcleo (o loop() roda neste)
+    xTaskCreatePinnedToCore(
+        missionTask,
+        "mission",
+        MISSION_TASK_STACK,
+        nullptr,
+        MISSION_TASK_PRIORITY,
+        &missionTaskHandle,
+        xPortGetCoreID() == 0 ? 1 : 0
+    );
+}
+
+// ========================================
+// MISSÕES
+// ========================================
+// Cada missão é um conjunto de ganchos (enter/tick/exit) registrado na
+// tabela MISSIONS logo abaixo. O loop() apenas chama o tick() da missão
+// ativa, então o custo por iteração não depende de quantas missões existem.
+
+// Consome um aperto de botão (borda de subida já sem repiques)
+// As bordas vêm da interrupção, então nenhum aperto se perde mesmo que
+// seja mais curto que uma iteração
+bool buttonPressed(unsigned long now) {
+    if (buttonPresses > 0) {
+        buttonPresses--;
+        return true;
+    }
+    return false;
+}
+
+// Gancho vazio para missões que não precisam de preparação ou limpeza
+void noop() {}
+
+// ==================================================
+// MODO IDLE - Estado inicial
+// ==================================================
+// Quando não há missão ativa, mantemos LEDs e buzzer desligados
+// (INTRO é teórica e usa o mesmo comportamento)
+void idleEnter() {
+    OutputPins::apply(0, OutputPins::mask(PIN_LED) | OutputPins::mask(PIN_LED_2));
+    OutputPins::noTone(PIN_BUZZER);
+}
+
+void idleTick(unsigned long now) {}
+
+// ==================================================
+// MISSÃO 1: LED SEMPRE ACESO
+// ==================================================
+// Conceito: Saída digital em nível HIGH constante
+// (repetido a cada tick, mas o pino só é escrito quando o nível muda)
+void mission1OnTick(unsigned long now) {
+    OutputPins::write(PIN_LED, HIGH);
+}
+
+// ==================================================
+// MISSÃO 1: LED PISCANDO
+// ==================================================
+// Objetivo: Alternar LED a cada 1 segundo (1000ms)
+// Conceito: Temporizador em vez de delay()
+// Por que não usar delay()? Porque delay() trava o programa inteiro!
+// O esp_timer chama o callback a cada 1000ms contados do disparo anterior,
+// então o pisca não acumula atraso e o tick da missão fica livre.
+void mission1BlinkEnter() {
+    // Começa apagado: a primeira troca (acende) vem depois de 1 segundo
+    ledWave.blink(1000, LOW);
+}
+
+// ==================================================
+// MISSÃO 2: LED COM RESISTOR 1K (PISCANDO 2s)
+// ==================================================
+void mission2Led1kEnter() {
+    // Pisca a cada 2 segundos (2000ms)
+    led2Wave.blink(2000, LOW);
+}
+
+void mission2Led1kExit() {
+    led2Wave.stop();
+    OutputPins::write(PIN_LED_2, LOW);
+}
+
+// ==================================================
+// MISSÃO 3: BUZZER (MÚSICA)
+// ==================================================
+// Conceito: uma melodia é uma lista de notas (frequência e duração)
+// O sequenciador toca a lista sozinho; a missão só manda começar e parar.
+void mission3BuzzerEnter() {
+    buzzerMelody.play();
+}
+
+void mission3BuzzerExit() {
+    buzzerMelody.stop();
+}
+
+// ==================================================
+// MISSÃO 2: BOTÃO COMO CAMPAINHA
+// ==================================================
+// Conceito: LED espelha o estado do botão em tempo real
+// Enquanto botão pressionado (HIGH), LED aceso. Quando solta, LED apaga.
+void mission2DoorbellTick(unsigned long now) {
+    OutputPins::write(PIN_LED, inputs.btn);
+}
+
+// ==================================================
+// MISSÃO 2: BOTÃO COMO INTERRUPTOR (TOGGLE)
+// ==================================================
+// Conceito: Cada aperto do botão ALTERNA o estado do LED
+// O LED fica aceso até o próximo aperto, então apaga, e assim por diante.
+void mission2ToggleTick(unsigned long now) {
+    // O debounce evita que um único aperto seja contado múltiplas vezes
+    if (buttonPressed(now)) {
+        toggleState = !toggleState;   // Inverte o estado do toggle
+    }
+
+    // Aplica o estado de toggle ao LED
+    OutputPins::write(PIN_LED, toggleState ? HIGH : LOW);
+}
+
+// ==================================================
+// MISSÃO 3: LEITURA DE POTENCIÔMETRO
+// ==================================================
+// Apenas envia telemetria do valor lido, sem controlar o LED
+// Mantemos LED apagado para não confundir visualmente
+void mission3ReadTick(unsigned long now) {
+    OutputPins::write(PIN_LED, LOW);
+}
+
+// ==================================================
+// MISSÃO 3: CONTROLE DE BRILHO COM PWM
+// ==================================================
+// Conceito: Potenciômetro controla intensidade do LED via PWM
+// O ADC do ESP32 retorna valores de 0 a 4095 (12 bits)
+// PWM trabalha com valores de 0 a 255 (8 bits)
+// Por isso usamos map() para converter a escala
+void mission3PwmTick(unsigned long now) {
+    // Converte valor do ADC (0-4095) para valor de PWM (0-255)
+    int pwmValue = map(inputs.pot, 0, 4095, 0, 255);
+
+    // Aplica o PWM ao LED (0 = apagado, 255 = brilho máximo)
+    ledWave.write(pwmValue);
+}
+
+void mission3PwmExit() {
+    ledWave.write(0);
+}
+
+// ==================================================
+// MISSÕES 4 E 5: MÁQUINA DE ESTADOS (3 MODOS)
+// ==================================================
+// Conceito: O botão cicla entre 3 modos de operação
+// Modo 0: LED desligado
+// Modo 1: LED sempre ligado
+// Modo 2: LED piscando a cada "blinkMs" ms
+// As duas missões usam a mesma tabela (mission_fsm.h) e só mudam o período
+// padrão do pisca: 200ms na Missão 4 e 100ms na Missão 5 (modo de alerta).
+// O período pode ser trocado com SET_PARAM.
+constexpr FsmTable<3, 1> modeCycle(uint16_t blinkMs) {
+    return {
+        {
+            //  ação       parâmetro     tempo          NONE PRESS TIMEOUT
+            { FSM_OFF,   FSM_NO_PARAM, FSM_NO_PARAM, { 0,   1,    0 } },
+            { FSM_ON,    FSM_NO_PARAM, FSM_NO_PARAM, { 1,   2,    1 } },
+            { FSM_BLINK, 0,            FSM_NO_PARAM, { 2,   0,    2 } },
+        },
+        {
+            { "blinkMs", blinkMs, 10, 10000 },
+        },
+    };
+}
+
+constexpr FsmTable<3, 1> MISSION_4_FSM = modeCycle(200);
+constexpr FsmTable<3, 1> MISSION_5_FSM = modeCycle(100);
+
+static_assert(MISSION_4_FSM.valid(), "Tabela da Missao 4 invalida");
+static_assert(MISSION_5_FSM.valid(), "Tabela da Missao 5 invalida");
+
+// Estado próprio de cada missão (modo, pisca e parâmetros)
+FsmMission mission4StateMachine(MISSION_4_FSM.view(), ledWave);
+FsmMission mission5Final(MISSION_5_FSM.view(), ledWave);
+
+// Ganchos de uma missão com máquina de estados, para a tabela MISSIONS
+template <FsmMission& fsm>
+void fsmEnter() {
+    fsm.enter(millis());
+}
+
+template <FsmMission& fsm>
+void fsmTick(unsigned long now) {
+    fsm.tick(now, buttonPressed(now));
+}
+
+template <FsmMission& fsm>
+void fsmExit() {
+    fsm.exit();
+}
+
+// Missões com parâmetros ajustáveis (SET_PARAM)
+struct FsmEntry {
+    MissionId id;
+    FsmMission* fsm;
+};
+
+const FsmEntry FSM_MISSIONS[] = {
+    { MissionId::MISSION_4_STATE_MACHINE, &mission4StateMachine },
+    { MissionId::MISSION_5_FINAL,         &mission5Final },
+};
+
+FsmMission* findFsm(MissionId id) {
+    for (const FsmEntry& entry : FSM_MISSIONS) {
+        if (entry.id == id) return entry.fsm;
+    }
+    return nullptr;
+}
+
+// Desliga o LED principal ao sair das missões que o controlam
+void ledOffExit() {
+    ledWave.stop();
+    OutputPins::write(PIN_LED, LOW);
+}
+
+// ==================================================
+// MISSÃO CUSTOM: PROGRAMA ENVIADO PELO HOST
+// ==================================================
+// Conceito: a lógica vem em bytecode (LOAD_MISSION, mission_program.h), então
+// uma lição nova ou um ajuste (período, melodia) não exige regravar o firmware
+// Sem programa carregado, se comporta como IDLE
+void customEnter() {
+    idleEnter();
+    customProgram.enter(millis());
+}
+
+void customTick(unsigned long now) {
+    MissionProgram::Inputs in;
+    in.pressed = buttonPressed(now);
+    in.button = inputs.btn;
+    in.pot = inputs.pot;
+    customProgram.tick(now, in);
+}
+
+void customExit() {
+    customProgram.exit();
+}
+
+// ========================================
+// REGISTRO DAS MISSÕES
+// ========================================
+// Uma entrada por MissionId, na mesma ordem do enum (mission_registry.h)
+constexpr Mission MISSIONS[] = {
+    { MissionId::IDLE,                    idleEnter, idleTick,                 noop },
+    { MissionId::INTRO,                   idleEnter, idleTick,                 noop },
+    { MissionId::MISSION_1_ON,            noop,      mission1OnTick,           ledOffExit },
+    { MissionId::MISSION_1_BLINK,         mission1BlinkEnter, idleTick,        ledOffExit },
+    { MissionId::MISSION_2_LED_1K,        mission2Led1kEnter, idleTick,        mission2Led1kExit },
+    { MissionId::MISSION_2_DOORBELL,      noop,      mission2DoorbellTick,     ledOffExit },
+    { MissionId::MISSION_2_TOGGLE,        noop,      mission2ToggleTick,       ledOffExit },
+    { MissionId::MISSION_3_BUZZER,        mission3BuzzerEnter, idleTick,       mission3BuzzerExit },
+    { MissionId::MISSION_3_READ,          noop,      mission3ReadTick,         noop },
+    { MissionId::MISSION_3_PWM,           noop,      mission3PwmTick,          mission3PwmExit },
+    { MissionId::MISSION_4_STATE_MACHINE, fsmEnter<mission4StateMachine>, fsmTick<mission4StateMachine>, fsmExit<mission4StateMachine> },
+    { MissionId::MISSION_5_FINAL,         fsmEnter<mission5Final>,        fsmTick<mission5Final>,        fsmExit<mission5Final> },
+    { MissionId::CUSTOM,                  customEnter, customTick,             customExit },
+};
+
+constexpr bool missionsInEnumOrder() {
+    for (size_t i = 0; i < MissionRegistry::COUNT; i++) {
+        if (static_cast<size_t>(MISSIONS[i].id) != i) return false;
+    }
+    return true;
+}
+
+static_assert(sizeof(MISSIONS) / sizeof(MISSIONS[0]) == MissionRegistry::COUNT,
+              "Toda MissionId precisa de uma entrada em MISSIONS");
+static_assert(missionsInEnumOrder(), "MISSIONS deve seguir a ordem do enum MissionId");
+
+// Troca a missão ativa: sai da anterior, reseta o estado e entra na nova
+void switchMission(MissionId id) {
+    if (currentMission != nullptr) {
+        currentMission->exit();
+    }
+
+    // Reseta variáveis de estado para evitar comportamento estranho
+    toggleState = false;
+
+    currentMission = &MISSIONS[static_cast<size_t>(id)];
+    currentMission->enter();
 }
 
 // ========================================
 // LÓGICA DAS MISSÕES
 // ========================================
-// Esta função é chamada continuamente no loop()
-// Ela decide qual comportamento executar baseado na missão atual
+// Lê as entradas do tick, uma única vez
+void readInputs(unsigned long now) {
+    // Consome as bordas do botão registradas pela interrupção
+    ButtonEdge edge;
+    uint8_t presses = 0;
+    while (button.next(edge, micros())) {
+        if (edge.pressed) presses++;
+    }
+
+    // Pega o valor mais recente do potenciômetro (sem esperar o ADC)
+    pot.poll();
+
+    inputs.seq++;
+    inputs.time = now;
+    inputs.btn = button.pressed() ? HIGH : LOW;  // HIGH se pressionado, LOW se solto
+    inputs.presses = presses;
+    const PotReading& reading = pot.reading();
+    inputs.pot = reading.value;                  // Valor de 0 a 4095
+    inputs.potMin = reading.min;                 // Estatísticas da janela recente
+    inputs.potMax = reading.max;
+    inputs.potMean = reading.mean;
+    buttonPresses = presses;
+}
+
+// Esta função é chamada a cada tick da tarefa das missões
+// Ela lê as entradas e executa a missão atual
 void handleMissionLogic() {
     // Captura o tempo atual (em milissegundos desde que o ESP32 ligou)
     unsigned long now = millis();
+    readInputs(now);
 
-    // Lê o estado atual dos sensores/entradas
-    buttonState = digitalRead(PIN_BUTTON);  // HIGH se pressionado, LOW se solto
-    potValue = analogRead(PIN_POT);         // Valor de 0 a 4095
-
-    // ==================================================
-    // MODO IDLE - Estado inicial
-    // ==================================================
-    // Quando não há missão ativa, mantemos o LED apagado
-    if (currentMission == "IDLE") {
-        digitalWrite(PIN_LED, LOW);
-        digitalWrite(PIN_LED_2, LOW);
-        noTone(PIN_BUZZER);
-    }
-
-    // ==================================================
-    // MISSÃO 1: LED SEMPRE ACESO
-    // ==================================================
-    // Conceito: Saída digital em nível HIGH constante
-    else if (currentMission == "MISSION_1_ON") {
-        digitalWrite(PIN_LED, HIGH);
-    }
-
-    // ==================================================
-    // MISSÃO 1: LED PISCANDO
-    // ==================================================
-    // Objetivo: Alternar LED a cada 1 segundo (1000ms)
-    // Conceito: Delay não-bloqueante usando millis()
-    // Por que não usar delay()? Porque delay() trava o programa inteiro!
-    else if (currentMission == "MISSION_1_BLINK") {
-        // Verifica se passou 1 segundo desde a última mudança
-        if (now - lastBlink >= 1000) {
-            lastBlink = now;          // Atualiza o momento da última mudança
-            ledState = !ledState;     // Inverte o estado (aceso ↔ apagado)
-
-            // Aplica o novo estado ao pino
-            digitalWrite(PIN_LED, ledState ? HIGH : LOW);
-        }
+    // Despacho direto para a missão ativa (sem comparar strings)
+    currentMission->tick(now);
+
+    // Publica o estado para a tarefa de comunicação, com a mesma leitura
+    // sobre a qual a missão agiu
+    // Se a fila estiver cheia, a comunicação está atrasada e só precisa
+    // da leitura mais recente: descartar esta não perde nada importante
+    SensorSnapshot snapshot;
+    snapshot.inputs = inputs;
+    snapshot.mission = currentMission->id;
+    snapshot.led = digitalRead(PIN_LED);
+    sensorSnapshots.push(snapshot);
+
+    // LED, botão ou missão mudaram: acorda a comunicação, que pode estar
+    // dormindo até o próximo prazo (telemetria por mudança sai na hora)
+    if (snapshot.mission != publishedSnapshot.mission
+        || snapshot.led != publishedSnapshot.led
+        || snapshot.inputs.btn != publishedSnapshot.inputs.btn) {
+        wakeCommTask();
     }
+    publishedSnapshot = snapshot;
+}
 
-    // ==================================================
-    // MISSÃO 2: LED COM RESISTOR 1K (PISCANDO 2s)
-    // ==================================================
-    else if (currentMission == "MISSION_2_LED_1K") {
-        // Pisca a cada 2 segundos (2000ms)
-        if (now - lastBlink >= 2000) {
-            lastBlink = now;
-            ledState = !ledState;
-            digitalWrite(PIN_LED_2, ledState ? HIGH : LOW);
-        }
+// Aplica um comando vindo da tarefa de comunicação
+void applyMissionCommand(const MissionCommand& command) {
+    switch (command.type) {
+        case MissionCommand::SET_MISSION:
+            switchMission(command.mission);
+            break;
+
+        case MissionCommand::SET_CAPTURE:
+            capturePeriod = command.value;
+            captureCountdown = 0;
+            break;
+
+        case MissionCommand::SET_PARAM:
+            findFsm(command.mission)->setParam(command.param, command.value);
+            break;
+
+        case MissionCommand::LOAD_PROGRAM:
+            // Um programa novo recomeça do estado 0 se já estiver rodando
+            if (currentMission->id == MissionId::CUSTOM) customProgram.exit();
+            customProgram.assign(programStore.data(), programStore.length());
+            programPending.store(false, std::memory_order_release);
+            if (currentMission->id == MissionId::CUSTOM) customProgram.enter(millis());
+            break;
+
+        case MissionCommand::LOAD_MELODY:
+            // A melodia nova começa do início se a Missão 3 estiver rodando
+            buzzerMelody.load(melodyUpload, melodyUploadCount, command.value != 0);
+            melodyPending.store(false, std::memory_order_release);
+            if (currentMission->id == MissionId::MISSION_3_BUZZER) buzzerMelody.play();
+            break;
     }
+}
 
-    // ==================================================
-    // MISSÃO 3: BUZZER (MÚSICA)
-    // ==================================================
-    else if (currentMission == "MISSION_3_BUZZER") {
-        if (now - lastNoteTime >= noteDuration) {
-            lastNoteTime = now;
-            tone(PIN_BUZZER, melody[currentNote], noteDuration);
-            currentNote++;
-            if (currentNote >= 8) currentNote = 0;
-        }
+// Registra uma amostra de todos os sinais do hardware_map.h
+void captureSample() {
+    CaptureSample sample;
+    sample.time = micros();
+    sample.pot = inputs.pot;
+    sample.levels = 0;
+    if (digitalRead(PIN_LED)) sample.levels |= CAPTURE_LED;
+    if (digitalRead(PIN_LED_2)) sample.levels |= CAPTURE_LED_2;
+    if (digitalRead(PIN_BUZZER)) sample.levels |= CAPTURE_BUZZER;
+    if (digitalRead(PIN_BUTTON)) sample.levels |= CAPTURE_BUTTON;
+
+    // Fila cheia: a comunicação não está dando conta dessa taxa. A amostra
+    // é descartada e o buraco aparece nos instantes enviados ao host.
+    captureSamples.push(sample);
+}
+
+// ========================================
+// TAREFA DAS MISSÕES
+// ========================================
+
+// Uma volta da tarefa: comandos pendentes, missão ativa e captura.
+// O simulador (native/sim.cpp) chama direto, em tempo virtual.
+void missionStep() {
+    MissionCommand command;
+    while (missionCommands.pop(command)) {
+        applyMissionCommand(command);
     }
 
-    // ==================================================
-    // MISSÃO 2: BOTÃO COMO CAMPAINHA
-    // ==================================================
-    // Conceito: LED espelha o estado do botão em tempo real
-    // Enquanto botão pressionado (HIGH), LED aceso. Quando solta, LED apaga.
-    else if (currentMission == "MISSION_2_DOORBELL") {
-        digitalWrite(PIN_LED, buttonState);
-    }
-
-    // ==================================================
-    // MISSÃO 2: BOTÃO COMO INTERRUPTOR (TOGGLE)
-    // ==================================================
-    // Conceito: Cada aperto do botão ALTERNA o estado do LED
-    // O LED fica aceso até o próximo aperto, então apaga, e assim por diante.
-    else if (currentMission == "MISSION_2_TOGGLE") {
-        // Detecta borda de subida: botão estava solto (LOW) e agora foi pressionado (HIGH)
-        // O debounce evita que um único aperto seja contado múltiplas vezes
-        if (buttonState == HIGH && lastButtonState == LOW && (now - lastDebounceTime > debounceDelay)) {
-            toggleState = !toggleState;   // Inverte o estado do toggle
-            lastDebounceTime = now;       // Marca o momento para debounce
-        }
+    handleMissionLogic();
 
-        // Aplica o estado de toggle ao LED
-        digitalWrite(PIN_LED, toggleState ? HIGH : LOW);
-    }
-
-    // ==================================================
-    // MISSÃO 3: LEITURA DE POTENCIÔMETRO
-    // ==================================================
-    // Apenas envia telemetria do valor lido, sem controlar o LED
-    // Mantemos LED apagado para não confundir visualmente
-    else if (currentMission == "MISSION_3_READ") {
-        digitalWrite(PIN_LED, LOW);
-    }
-
-    // ==================================================
-    // MISSÃO 3: CONTROLE DE BRILHO COM PWM
-    // ==================================================
-    // Conceito: Potenciômetro controla intensidade do LED via PWM
-    // O ADC do ESP32 retorna valores de 0 a 4095 (12 bits)
-    // PWM trabalha com valores de 0 a 255 (8 bits)
-    // Por isso usamos map() para converter a escala
-    else if (currentMission == "MISSION_3_PWM") {
-        // Converte valor do ADC (0-4095) para valor de PWM (0-255)
-        int pwmValue = map(potValue, 0, 4095, 0, 255);
-
-        // Aplica o PWM ao LED (0 = apagado, 255 = brilho máximo)
-        analogWrite(PIN_LED, pwmValue);
-    }
-
-    // ==================================================
-    // MISSÃO 4: MÁQUINA DE ESTADOS (3 MODOS)
-    // ==================================================
-    // Conceito: O botão cicla entre 3 modos de operação
-    // Modo 0: LED desligado
-    // Modo 1: LED sempre ligado
-    // Modo 2: LED piscando (200ms on/off)
-    else if (currentMission == "MISSION_4_STATE_MACHINE") {
-        // A cada aperto do botão, avançamos para o próximo modo
-        if (buttonState == HIGH && lastButtonState == LOW && (now - lastDebounceTime > debounceDelay)) {
-            mode++;                     // Incrementa o modo
-            if (mode > 2) mode = 0;    // Quando passa de 2, volta para 0 (ciclo circular)
-            lastDebounceTime = now;     // Atualiza debounce
-        }
+    if (capturePeriod > 0 && ++captureCountdown >= capturePeriod) {
+        captureCountdown = 0;
+        captureSample();
+    }
+}
 
-        // Executa comportamento baseado no modo atual
-        if (mode == 0) {
-            // Modo 0: Desligado
-            digitalWrite(PIN_LED, LOW);
-        }
-        else if (mode == 1) {
-            // Modo 1: Sempre ligado
-            digitalWrite(PIN_LED, HIGH);
-        }
-        else if (mode == 2) {
-            // Modo 2: Piscando a cada 200ms (pisca mais rápido que Missão 1)
-            if (now - lastBlink >= 200) {
-                lastBlink = now;
-                ledState = !ledState;
-                digitalWrite(PIN_LED, ledState ? HIGH : LOW);
-            }
+// Roda em um núcleo só seu, em período fixo (vTaskDelayUntil não acumula
+// atraso), e nunca espera pela Serial. A flash é outra história: durante um
+// commit da NVS feito pelo loop() o cache da flash fica desligado nos dois
+// núcleos, e esta tarefa pode parar por alguns milissegundos até ele voltar
+void missionTask(void* parameter) {
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        uint32_t start = LoopProfiler::now();
+        missionStep();
+        profiler.record(LoopProfiler::MISSION, start);
+
+        // Terminou depois do próximo despertar: o tick seguinte sai atrasado
+        if (xTaskGetTickCount() - lastWake >= MISSION_PERIOD) {
+            profiler.missedDeadline();
         }
+
+        vTaskDelayUntil(&lastWake, MISSION_PERIOD);
     }
+}
 
-    // ==================================================
-    // MISSÃO 5: PROJETO FINAL
-    // ==================================================
-    // Similar à Missão 4, mas o modo 2 pisca AINDA MAIS RÁPIDO (100ms)
-    // Isso simula diferentes modos de alerta ou funcionamento
-    // Modo 0: Escuro (desligado)
-    // Modo 1: Luz Normal (sempre ligado)
-    // Modo 2: Alerta (pisca rápido)
-    else if (currentMission == "MISSION_5_FINAL") {
-        // Avança modo a cada aperto do botão
-        if (buttonState == HIGH && lastButtonState == LOW && (now - lastDebounceTime > debounceDelay)) {
-            mode++;
-            if (mode > 2) mode = 0;
-            lastDebounceTime = now;
-        }
+// ========================================
+// TELEMETRIA (tarefa de comunicação)
+// ========================================
+
+// Esvazia a fila de leituras e guarda apenas a mais recente
+void receiveSnapshots() {
+    SensorSnapshot snapshot;
+    while (sensorSnapshots.pop(snapshot)) {
+        latestSnapshot = snapshot;
+    }
+}
+
+// Envia JSON com o estado capturado pela tarefa das missões
+void sendSnapshot(const SensorSnapshot& snapshot) {
+    protocol.sendTelemetry(
+        userStore.getUserId(),
+        userStore.generation(),
+        snapshot.mission,
+        snapshot.led,
+        snapshot.inputs,
+        telemetryConfig.extended
+    );
+    lastSentSnapshot = snapshot;
+}
 
-        // Executa comportamento do modo
-        if (mode == 0) {
-            // Modo 0: Escuro
-            digitalWrite(PIN_LED, LOW);
+// O estado mudou o suficiente desde o último quadro enviado?
+bool snapshotChanged(const SensorSnapshot& current, const SensorSnapshot& sent) {
+    int potDelta = (int)current.inputs.pot - (int)sent.inputs.pot;
+    if (potDelta < 0) potDelta = -potDelta;
+
+    return current.mission != sent.mission
+        || current.led != sent.led
+        || current.inputs.btn != sent.inputs.btn
+        || potDelta > telemetryConfig.deadband;
+}
+
+// Junta as amostras da captura e envia cada lote completo
+void receiveCaptureSamples() {
+    CaptureSample sample;
+    while (captureSamples.pop(sample)) {
+        captureBatch[captureCount++] = sample;
+        if (captureCount >= captureBatchSize) {
+            protocol.sendSamples(captureBatch, captureCount);
+            captureCount = 0;
         }
-        else if (mode == 1) {
-            // Modo 1: Luz Normal
-            digitalWrite(PIN_LED, HIGH);
+    }
+}
+
+// Maior velocidade suportada que não passa da pedida (0 se nenhuma serve)
+uint32_t chooseBaud(long requested) {
+    for (uint32_t baud : SERIAL_BAUD_RATES) {
+        if ((long)baud <= requested) return baud;
+    }
+    return 0;
+}
+
+// Aplica o formato e o enquadramento aos dois sentidos do link
+void applyLinkFormat(Protocol::Format format, Protocol::Framing framing) {
+    protocol.setFormat(format);
+    protocol.setFraming(framing);
+    if (framing == Protocol::COBS) {
+        commandReader.setFraming(CommandReader::COBS);
+    } else {
+        commandReader.setFraming(format == Protocol::MSGPACK ? CommandReader::LENGTH_PREFIXED : CommandReader::LINES);
+    }
+}
+
+// Troca a velocidade só depois que tudo o que já foi escrito saiu na antiga
+void switchBaud(uint32_t baud) {
+    Serial.flush();
+    Serial.updateBaudRate(baud);
+    commandReader.reset();
+    serialBaud = baud;
+    baudChangedAt = millis();
+}
+
+// O link está como o host o abre: 115200, linhas de JSON, sem COBS
+bool linkAtDefaults() {
+    return serialBaud == SERIAL_DEFAULT_BAUD && protocol.getFormat() == Protocol::JSON
+        && protocol.getFraming() == Protocol::PLAIN;
+}
+
+// Volta para 115200 se a nova velocidade não foi confirmada a tempo, ou se
+// o host parou de falar: ele sempre reabre a porta em 115200, em JSON e sem
+// o enquadramento COBS, que também voltam ao padrão
+void checkBaud(unsigned long now) {
+    if (baudConfirming && now - baudChangedAt >= BAUD_CONFIRM_TIMEOUT) {
+        baudConfirming = false;
+        switchBaud(SERIAL_DEFAULT_BAUD);
+    } else if (!baudConfirming && now - lastValidCommand >= BAUD_IDLE_TIMEOUT && !linkAtDefaults()) {
+        if (serialBaud != SERIAL_DEFAULT_BAUD) switchBaud(SERIAL_DEFAULT_BAUD);
+        applyLinkFormat(Protocol::JSON, Protocol::PLAIN);
+    }
+}
+
+// Arma a volta para 115200: fim da espera pelo PING ou host em silêncio
+void scheduleBaudCheck() {
+    if (baudConfirming) {
+        scheduler.at(baudTimer, baudChangedAt + BAUD_CONFIRM_TIMEOUT);
+    } else if (!linkAtDefaults()) {
+        scheduler.at(baudTimer, lastValidCommand + BAUD_IDLE_TIMEOUT);
+    } else {
+        scheduler.cancel(baudTimer);
+    }
+}
+
+// Aplica um SET_CAPTURE: rateHz = 0 desliga a captura
+bool configureCapture(const Protocol::Command& cmd) {
+    if (cmd.rateHz < 0 || cmd.rateHz > 1000) return false;
+    if (cmd.batch != -1 && (cmd.batch < 1 || cmd.batch > (long)Protocol::MAX_SAMPLES)) return false;
+
+    MissionCommand command;
+    command.type = MissionCommand::SET_CAPTURE;
+    // A tarefa das missões roda a cada 1ms: a taxa vira um período inteiro
+    command.value = cmd.rateHz == 0 ? 0 : (1000 + cmd.rateHz / 2) / cmd.rateHz;
+    if (!missionCommands.push(command)) return false;
+
+    // Descarta o lote da configuração anterior
+    CaptureSample discarded;
+    while (captureSamples.pop(discarded)) {}
+    captureCount = 0;
+    if (cmd.batch != -1) captureBatchSize = cmd.batch;
+    return true;
+}
+
+// Arma o próximo envio de telemetria, conforme o modo configurado.
+// Por mudança, sem nada novo, o prazo é o do heartbeat; uma mudança
+// antecipa para o fim do intervalo mínimo.
+void scheduleTelemetry() {
+    unsigned long wait = telemetryConfig.interval;
+    if (telemetryConfig.onChange && !snapshotChanged(latestSnapshot, lastSentSnapshot)
+        && telemetryConfig.heartbeat > wait) {
+        wait = telemetryConfig.heartbeat;
+    }
+    scheduler.at(telemetryTimer, lastTelemetry + wait);
+}
+
+// Prazo da telemetria vencido: envia o estado atual
+void sendTelemetry(unsigned long now) {
+    // Periódica: o próximo prazo conta do anterior, então acordar um pouco
+    // atrasado não empurra os quadros seguintes. Atrasou mais de um período
+    // inteiro (ex: Serial lenta)? Recomeça de agora, sem rajada.
+    unsigned long deadline = scheduler.deadline(telemetryTimer);
+    bool onTime = !telemetryConfig.onChange && now - deadline < telemetryConfig.interval;
+    lastTelemetry = onTime ? deadline : now;
+
+    // Envia JSON com estado atual: LED, botão, potenciômetro
+    sendSnapshot(latestSnapshot);
+}
+
+// Aplica um SET_TELEMETRY; campos ausentes mantêm o valor atual
+bool configureTelemetry(const Protocol::Command& cmd) {
+    TelemetryConfig config = telemetryConfig;
+
+    if (strcmp(cmd.mode, "periodic") == 0) {
+        config.onChange = false;
+    } else if (strcmp(cmd.mode, "change") == 0) {
+        config.onChange = true;
+    } else if (cmd.mode[0] != '\0') {
+        return false;
+    }
+
+    if (cmd.intervalMs != -1) {
+        if (cmd.intervalMs < (long)TELEMETRY_MIN_INTERVAL || cmd.intervalMs > (long)TELEMETRY_MAX_INTERVAL) return false;
+        config.interval = cmd.intervalMs;
+    }
+    if (cmd.heartbeatMs != -1) {
+        if (cmd.heartbeatMs < (long)TELEMETRY_MIN_INTERVAL || cmd.heartbeatMs > (long)TELEMETRY_MAX_INTERVAL) return false;
+        config.heartbeat = cmd.heartbeatMs;
+    }
+    if (cmd.deadband != -1) {
+        if (cmd.deadband < 0 || cmd.deadband > 4095) return false;
+        config.deadband = cmd.deadband;
+    }
+    if (cmd.extended != -1) {
+        config.extended = cmd.extended;
+    }
+
+    telemetryConfig = config;
+    return true;
+}
+
+// ========================================
+// COMANDOS
+// ========================================
+// Um tratador por Protocol::CommandType, registrado na tabela
+// COMMAND_HANDLERS logo abaixo. O comando chega sem nenhuma String: o
+// caminho inteiro, da Serial à resposta, não usa o heap.
+
+// Tipo desconhecido: responde com erro para o host não ficar esperando
+void handleUnknown(const Protocol::Command& cmd) {
+    protocol.sendError(Protocol::STATUS_UNKNOWN_COMMAND, "Unknown command");
+}
+
+// --------------------------------------------------
+// COMANDO: SET_ID
+// --------------------------------------------------
+// Define o ID do usuário e armazena na EEPROM (memória persistente)
+// Exemplo: {"type": "SET_ID", "userId": "abc123"}
+void handleSetId(const Protocol::Command& cmd) {
+    if (userStore.setUserId(cmd.userId)) {
+        protocol.sendAck(Protocol::SET_ID);  // Confirma recebimento
+    } else {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid userId");
+    }
+}
+
+// --------------------------------------------------
+// COMANDO: SET_MISSION
+// --------------------------------------------------
+// Muda a missão ativa e reseta estados para começar limpo
+// O nome é resolvido uma única vez aqui (hash perfeito), e não a cada loop
+// Exemplo: {"type": "SET_MISSION", "missionId": "MISSION_1_BLINK"}
+void handleSetMission(const Protocol::Command& cmd) {
+    MissionCommand command;
+    command.type = MissionCommand::SET_MISSION;
+
+    if (!MissionRegistry::lookup(cmd.missionId, strlen(cmd.missionId), command.mission)) {
+        protocol.sendError(Protocol::STATUS_UNKNOWN_MISSION, "Unknown mission");
+    } else if (!missionCommands.push(command)) {
+        protocol.sendError(Protocol::STATUS_BUSY, "Busy");
+    } else {
+        requestedMission = command.mission;
+        protocol.sendAck(Protocol::SET_MISSION);  // Confirma mudança
+    }
+}
+
+// --------------------------------------------------
+// COMANDO: GET_STATUS
+// --------------------------------------------------
+// Envia telemetria imediata (fora do ciclo periódico)
+// Exemplo: {"type": "GET_STATUS"}
+void handleGetStatus(const Protocol::Command& cmd) {
+    receiveSnapshots();
+    sendSnapshot(latestSnapshot);
+}
+
+// --------------------------------------------------
+// COMANDO: GET_VERSION
+// --------------------------------------------------
+// Retorna a versão atual do firmware
+// Exemplo: {"type": "GET_VERSION"}
+void handleGetVersion(const Protocol::Command& cmd) {
+    protocol.sendVersion(FIRMWARE_VERSION, FIRMWARE_BUILD, FIRMWARE_DATE);
+}
+
+// --------------------------------------------------
+// COMANDO: SET_FORMAT
+// --------------------------------------------------
+// Troca a codificação do link entre JSON (texto) e MessagePack
+// (binário, com 2 bytes de tamanho antes de cada mensagem) e, com "framing",
+// liga ou desliga o enquadramento COBS com CRC-16 (ver frame_codec.h).
+// Campos ausentes mantêm o valor atual.
+// O ACK ainda sai no formato antigo; tudo depois dele usa o novo
+// Exemplo: {"type": "SET_FORMAT", "format": "msgpack"}
+// Exemplo: {"type": "SET_FORMAT", "format": "json", "framing": "cobs"}
+void handleSetFormat(const Protocol::Command& cmd) {
+    Protocol::Format format = protocol.getFormat();
+    if (strcmp(cmd.format, "msgpack") == 0) {
+        format = Protocol::MSGPACK;
+    } else if (strcmp(cmd.format, "json") == 0) {
+        format = Protocol::JSON;
+    } else if (cmd.format[0] != '\0') {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Unknown format");
+        return;
+    }
+
+    Protocol::Framing framing = protocol.getFraming();
+    if (strcmp(cmd.framing, "cobs") == 0) {
+        framing = Protocol::COBS;
+    } else if (strcmp(cmd.framing, "none") == 0) {
+        framing = Protocol::PLAIN;
+    } else if (cmd.framing[0] != '\0') {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Unknown framing");
+        return;
+    }
+
+    if (cmd.format[0] == '\0' && cmd.framing[0] == '\0') {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Missing format");
+        return;
+    }
+
+    protocol.sendAck(Protocol::SET_FORMAT);
+    applyLinkFormat(format, framing);
+}
+
+// --------------------------------------------------
+// COMANDO: SET_TELEMETRY
+// --------------------------------------------------
+// Ajusta a telemetria automática. Todos os campos são opcionais:
+// - mode: "periodic" (padrão) ou "change" (só quando algo muda)
+// - intervalMs: período, ou intervalo mínimo no modo "change" (1 a 60000)
+// - heartbeatMs: no modo "change", envia mesmo sem mudança após esse tempo
+// - deadband: variação do potenciômetro que conta como mudança
+// - extended: true inclui potMin/potMax/potMean e "tick" (padrão false, o
+//   esquema original)
+// Exemplo: {"type": "SET_TELEMETRY", "mode": "change", "intervalMs": 20, "deadband": 32}
+void handleSetTelemetry(const Protocol::Command& cmd) {
+    if (configureTelemetry(cmd)) {
+        protocol.sendAck(Protocol::SET_TELEMETRY);
+    } else {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid telemetry config");
+    }
+}
+
+// --------------------------------------------------
+// COMANDO: SET_CAPTURE
+// --------------------------------------------------
+// Liga a captura em alta taxa para desenhar formas de onda
+// - rateHz: amostras por segundo (1 a 1000; 0 desliga)
+// - batch: amostras por quadro SAMPLES (1 a 32, padrão 16)
+// Exemplo: {"type": "SET_CAPTURE", "rateHz": 500, "batch": 32}
+void handleSetCapture(const Protocol::Command& cmd) {
+    if (configureCapture(cmd)) {
+        protocol.sendAck(Protocol::SET_CAPTURE);
+    } else {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid capture config");
+    }
+}
+
+// --------------------------------------------------
+// COMANDO: GET_METRICS
+// --------------------------------------------------
+// Retorna os histogramas de tempo de cada etapa e quantas vezes
+// a tarefa das missões perdeu o seu período
+// - reset: zera as medidas depois de enviar
+// Exemplo: {"type": "GET_METRICS", "reset": true}
+void handleGetMetrics(const Protocol::Command& cmd) {
+    protocol.sendMetrics(profiler);
+    if (cmd.reset) profiler.reset();
+}
+
+// --------------------------------------------------
+// COMANDO: SET_BAUD
+// --------------------------------------------------
+// Negocia uma Serial mais rápida. A placa escolhe a maior velocidade
+// suportada até "baud" e responde com ela no ACK, ainda na velocidade atual;
+// logo depois as duas pontas trocam, e o host confirma com um PING na nova.
+// Sem PING em 1s, a placa volta para 115200.
+// Exemplo: {"type": "SET_BAUD", "baud": 2000000}
+void handleSetBaud(const Protocol::Command& cmd) {
+    uint32_t baud = chooseBaud(cmd.baud);
+    if (baud == 0) {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid baud");
+        return;
+    }
+
+    protocol.sendBaud(baud);
+    if (baud != serialBaud) {
+        switchBaud(baud);
+        baudConfirming = true;
+    }
+}
+
+// --------------------------------------------------
+// COMANDO: PING
+// --------------------------------------------------
+// Responde PONG. Confirma uma troca de velocidade pendente e, fora de
+// 115200, serve de sinal de vida do host.
+// Exemplo: {"type": "PING"}
+void handlePing(const Protocol::Command& cmd) {
+    baudConfirming = false;
+    protocol.sendPong();
+}
+
+// --------------------------------------------------
+// COMANDO: LOAD_MISSION
+// --------------------------------------------------
+// Envia o programa da missão CUSTOM (bytecode, ver mission_program.h) em
+// pedaços base64 (cada comando cabe numa linha de 256 bytes: ~96 bytes de
+// programa por pedaço), com um ACK por pedaço.
+// O último pedaço só recebe ACK depois de o programa inteiro ser validado e
+// gravado na NVS; a missão CUSTOM passa a usá-lo imediatamente.
+// - offset: posição do pedaço no programa (0 começa um envio novo)
+// - size: tamanho total do programa em bytes
+// - data: o pedaço em base64
+// Exemplo (pisca o LED 2 a cada 2s):
+// {"type": "LOAD_MISSION", "offset": 0, "size": 12, "data": "AQEAAAAIAAfQAgEA"}
+void handleLoadMission(const Protocol::Command& cmd) {
+    // A tarefa das missões ainda não copiou o programa anterior
+    if (programPending.load(std::memory_order_acquire)) {
+        protocol.sendError(Protocol::STATUS_BUSY, "Program pending");
+        return;
+    }
+
+    MissionProgramStore::Result result = programStore.receive(cmd.offset, cmd.size, cmd.data);
+    if (result == MissionProgramStore::INVALID) {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid program");
+        return;
+    }
+
+    if (result == MissionProgramStore::COMPLETE) {
+        MissionCommand command;
+        command.type = MissionCommand::LOAD_PROGRAM;
+        programPending.store(true, std::memory_order_release);
+        if (!missionCommands.push(command)) {
+            // Gravado na NVS: vale no próximo reinício ou envio
+            programPending.store(false, std::memory_order_release);
+            protocol.sendError(Protocol::STATUS_BUSY, "Mission queue full");
+            return;
         }
-        else if (mode == 2) {
-            // Modo 2: Alerta (pisca MUITO rápido - 100ms)
-            if (now - lastBlink >= 100) {
-                lastBlink = now;
-                ledState = !ledState;
-                digitalWrite(PIN_LED, ledState ? HIGH : LOW);
-            }
+    }
+
+    protocol.sendAck(Protocol::LOAD_MISSION);
+}
+
+// --------------------------------------------------
+// COMANDO: SET_PARAM
+// --------------------------------------------------
+// Troca um parâmetro de uma missão com máquina de estados. Vale até o
+// ESP32 reiniciar, mesmo trocando de missão.
+// - missionId: missão (opcional, padrão: a do último SET_MISSION)
+// - param: nome do parâmetro (ex: "blinkMs" nas Missões 4 e 5)
+// - value: novo valor, dentro da faixa do parâmetro
+// Exemplo: {"type": "SET_PARAM", "missionId": "MISSION_5_FINAL", "param": "blinkMs", "value": 50}
+void handleSetParam(const Protocol::Command& cmd) {
+    MissionId id = requestedMission;
+    if (cmd.missionId[0] != '\0' && !MissionRegistry::lookup(cmd.missionId, strlen(cmd.missionId), id)) {
+        protocol.sendError(Protocol::STATUS_UNKNOWN_MISSION, "Unknown mission");
+        return;
+    }
+
+    FsmMission* fsm = findFsm(id);
+    int param = fsm ? fsm->paramIndex(cmd.param) : -1;
+    if (param < 0 || !fsm->paramInRange(param, cmd.value)) {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid parameter");
+        return;
+    }
+
+    MissionCommand command;
+    command.type = MissionCommand::SET_PARAM;
+    command.mission = id;
+    command.param = param;
+    command.value = cmd.value;
+    if (!missionCommands.push(command)) {
+        protocol.sendError(Protocol::STATUS_BUSY, "Mission queue full");
+        return;
+    }
+    protocol.sendAck(Protocol::SET_PARAM);
+}
+
+// --------------------------------------------------
+// COMANDO: PLAY
+// --------------------------------------------------
+// Troca a melodia da Missão 3 (MISSION_3_BUZZER) até o ESP32 reiniciar. Se a
+// missão estiver rodando, a melodia nova começa na hora.
+// - rtttl: melodia em RTTTL (ver rtttl.h), ou
+// - data: notas em base64, 4 bytes cada (Hz e ms, 16 bits big-endian; 0 Hz = pausa)
+// - loop: repetir ao fim (padrão true)
+// Até MelodySequencer::MAX_NOTES notas, dentro de uma linha de 256 bytes.
+// Exemplo: {"type": "PLAY", "rtttl": "escala:d=4,o=5,b=120:c,d,e,f,g,a,b,c6", "loop": false}
+void handlePlay(const Protocol::Command& cmd) {
+    // A tarefa das missões ainda não copiou a melodia anterior
+    if (melodyPending.load(std::memory_order_acquire)) {
+        protocol.sendError(Protocol::STATUS_BUSY, "Melody pending");
+        return;
+    }
+
+    size_t count = 0;
+    if (cmd.rtttl[0] != '\0') {
+        count = Rtttl::parse(cmd.rtttl, melodyUpload, MelodySequencer::MAX_NOTES);
+    } else {
+        uint8_t bytes[MelodySequencer::MAX_NOTES * MelodySequencer::NOTE_BYTES];
+        long length = Base64::decode(cmd.data, bytes, sizeof(bytes));
+        if (length > 0) {
+            count = MelodySequencer::unpack(bytes, length, melodyUpload, MelodySequencer::MAX_NOTES);
         }
     }
+    if (count == 0) {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid melody");
+        return;
+    }
+
+    MissionCommand command;
+    command.type = MissionCommand::LOAD_MELODY;
+    command.value = cmd.loop ? 1 : 0;
+    melodyUploadCount = count;
+    melodyPending.store(true, std::memory_order_release);
+    if (!missionCommands.push(command)) {
+        melodyPending.store(false, std::memory_order_release);
+        protocol.sendError(Protocol::STATUS_BUSY, "Mission queue full");
+        return;
+    }
+    protocol.sendAck(Protocol::PLAY);
+}
+
+struct CommandHandler {
+    Protocol::CommandType type;
+    void (*handle)(const Protocol::Command& cmd);
+};
+
+// Uma entrada por Protocol::CommandType, na mesma ordem do enum
+constexpr CommandHandler COMMAND_HANDLERS[] = {
+    { Protocol::UNKNOWN_COMMAND, handleUnknown },
+    { Protocol::SET_ID,          handleSetId },
+    { Protocol::SET_MISSION,     handleSetMission },
+    { Protocol::GET_STATUS,      handleGetStatus },
+    { Protocol::GET_VERSION,     handleGetVersion },
+    { Protocol::SET_FORMAT,      handleSetFormat },
+    { Protocol::SET_TELEMETRY,   handleSetTelemetry },
+    { Protocol::SET_CAPTURE,     handleSetCapture },
+    { Protocol::GET_METRICS,     handleGetMetrics },
+    { Protocol::SET_BAUD,        handleSetBaud },
+    { Protocol::PING,            handlePing },
+    { Protocol::LOAD_MISSION,    handleLoadMission },
+    { Protocol::SET_PARAM,       handleSetParam },
+    { Protocol::PLAY,            handlePlay },
+};
+
+constexpr bool handlersInEnumOrder() {
+    for (size_t i = 0; i < Protocol::COMMAND_COUNT; i++) {
+        if (static_cast<size_t>(COMMAND_HANDLERS[i].type) != i) return false;
+    }
+    return true;
+}
+
+static_assert(sizeof(COMMAND_HANDLERS) / sizeof(COMMAND_HANDLERS[0]) == Protocol::COMMAND_COUNT,
+              "Todo Protocol::CommandType precisa de uma entrada em COMMAND_HANDLERS");
+static_assert(handlersInEnumOrder(), "COMMAND_HANDLERS deve seguir a ordem do enum CommandType");
+
+// Um comando completo (linha ou quadro): parse, tratador e resposta.
+// O simulador (native/sim.cpp) chama direto, como faz com missionStep().
+void handleCommand(char* line, size_t length) {
+    // Parser JSON: converte a linha (terminada em '\n') em um comando estruturado
+    // CRC do comando antes do parse, que escreve no buffer: identifica
+    // um reenvio junto com o "seq"
+    uint16_t commandCrc = FrameCodec::crc16(reinterpret_cast<const uint8_t*>(line), length);
 
-    // Atualiza o estado anterior do botão para a próxima iteração
-    // Isso é essencial para detectar mudanças (bordas de subida/descida)
-    lastButtonState = buttonState;
+    uint32_t stageStart = LoopProfiler::now();
+    Protocol::Command cmd = protocol.parse(line, length);
+    profiler.record(LoopProfiler::PARSE, stageStart);
+
+    // Se o comando for válido (JSON bem formado), despacha direto para
+    // o seu tratador, sem comparar strings
+    // As respostas enviadas pelo tratador levam o "seq" do comando
+    // Um comando repetido (reenvio depois de um NAK) já atendido só
+    // recebe a mesma resposta de novo
+    if (cmd.valid) {
+        lastValidCommand = millis();
+        if (cmd.seq < 0 || !protocol.resendReply(cmd.seq, commandCrc)) {
+            protocol.setReplySeq(cmd.seq, commandCrc);
+            COMMAND_HANDLERS[cmd.type].handle(cmd);
+            protocol.setReplySeq(-1);
+        }
+    }
+    // Com o CRC conferido, um conteúdo ilegível é erro do host; sem
+    // enquadramento, pode ser só ruído na linha: pede o reenvio
+    else if (protocol.getFraming() == Protocol::COBS) {
+        protocol.sendError(Protocol::STATUS_INVALID_ARGUMENT, "Invalid command");
+    } else {
+        protocol.sendNak();
+    }
 }
 
 // ========================================
 // LOOP - Executado CONTINUAMENTE
 // ========================================
 // O loop() roda infinitamente enquanto o ESP32 está ligado
-// Aqui processamos comandos Serial, executamos lógica das missões e enviamos telemetria
+// Ele é a tarefa de comunicação: processa comandos Serial e envia telemetria,
+// e dorme quando não há nada a fazer (a CPU fica livre em vez de girar)
+// A lógica das missões roda na tarefa missionTask, no outro núcleo
 void loop() {
+    uint32_t loopStart = LoopProfiler::now();
+
     // ========================================
     // 1. PROCESSAR COMANDOS RECEBIDOS VIA SERIAL
     // ========================================
-    // Verifica se há dados disponíveis na Serial (comandos JSON da plataforma)
-    if (Serial.available()) {
-        // Lê uma linha completa até encontrar '\n' (quebra de linha)
-        String line = Serial.readStringUntil('\n');
-
-        // Parser JSON: converte a string em um comando estruturado
-        Protocol::Command cmd = protocol.parse(line);
-
-        // Se o comando for válido (JSON bem formado), processa
-        if (cmd.valid) {
-            // --------------------------------------------------
-            // COMANDO: SET_ID
-            // --------------------------------------------------
-            // Define o ID do usuário e armazena na EEPROM (memória persistente)
-            // Exemplo: {"type": "SET_ID", "userId": "abc123"}
-            if (cmd.type == "SET_ID") {
-                userStore.setUserId(cmd.userId);
-                protocol.sendAck("SET_ID");  // Confirma recebimento
-            }
-
-            // --------------------------------------------------
-            // COMANDO: SET_MISSION
-            // --------------------------------------------------
-            // Muda a missão ativa e reseta estados para começar limpo
-            // Exemplo: {"type": "SET_MISSION", "missionId": "MISSION_1_BLINK"}
-            else if (cmd.type == "SET_MISSION") {
-                currentMission = cmd.missionId;  // Atualiza missão
-
-                // Reseta variáveis de estado para evitar comportamento estranho
-                ledState = false;
-                toggleState = false;
-                mode = 0;
-
-                protocol.sendAck("SET_MISSION");  // Confirma mudança
-            }
-
-            // --------------------------------------------------
-            // COMANDO: GET_STATUS
-            // --------------------------------------------------
-            // Envia telemetria imediata (fora do ciclo periódico)
-            // Exemplo: {"type": "GET_STATUS"}
-            else if (cmd.type == "GET_STATUS") {
-                protocol.sendTelemetry(
-                    userStore.getUserId(),
-                    currentMission,
-                    digitalRead(PIN_LED),
-                    digitalRead(PIN_BUTTON),
-                    analogRead(PIN_POT)
-                );
-            }
-
-            // --------------------------------------------------
-            // COMANDO: GET_VERSION
-            // --------------------------------------------------
-            // Retorna a versão atual do firmware
-            // Exemplo: {"type": "GET_VERSION"}
-            else if (cmd.type == "GET_VERSION") {
-                protocol.sendVersion(FIRMWARE_VERSION, FIRMWARE_BUILD, FIRMWARE_DATE);
-            }
-        }
-        // Caso o JSON seja inválido, poderíamos enviar erro (comentado)
-        // else {
-        //     protocol.sendError("Invalid JSON");
-        // }
+    // Junta os bytes que já chegaram na Serial (comandos JSON da plataforma)
+    // Nunca espera: se a linha ainda não terminou, seguimos para a missão
+    uint32_t stageStart = LoopProfiler::now();
+    CommandReader::Status status = commandReader.poll(Serial);
+    profiler.record(LoopProfiler::READ, stageStart);
+
+    if (status == CommandReader::TOO_LONG) {
+        protocol.sendError(Protocol::STATUS_TOO_LONG, "Line too long");
+    }
+
+    // Quadro COBS corrompido: o leitor já pulou para o próximo 0x00
+    if (status == CommandReader::BAD_FRAME) {
+        protocol.sendNak();
+    }
+
+    if (status == CommandReader::LINE) {
+        handleCommand(commandReader.line(), commandReader.length());
     }
 
     // ========================================
-    // 2. EXECUTAR LÓGICA DA MISSÃO ATUAL
+    // 2. RECEBER O ESTADO DA TAREFA DAS MISSÕES
     // ========================================
-    // Chama a função que controla o comportamento do LED/sensores
-    handleMissionLogic();
+    receiveSnapshots();
+    receiveCaptureSamples();
 
     // ========================================
-    // 3. ENVIAR TELEMETRIA PERIÓDICA
+    // 3. ENVIAR TELEMETRIA E CONFERIR A VELOCIDADE DA SERIAL
     // ========================================
-    // A cada 500ms, envia automaticamente o estado dos sensores para a plataforma
+    // Por padrão, a cada 500ms envia automaticamente o estado dos sensores
     // Isso permite que o frontend monitore em tempo real o que está acontecendo
-    if (millis() - lastTelemetry >= TELEMETRY_INTERVAL) {
-        lastTelemetry = millis();  // Atualiza timestamp
-
-        // Envia JSON com estado atual: LED, botão, potenciômetro
-        protocol.sendTelemetry(
-            userStore.getUserId(),
-            currentMission,
-            digitalRead(PIN_LED),
-            digitalRead(PIN_BUTTON),
-            analogRead(PIN_POT)
-        );
+    // (SET_TELEMETRY muda o período ou passa a enviar só quando algo muda)
+    // Os prazos são recalculados a cada volta: um comando ou uma leitura
+    // nova podem antecipá-los ou adiá-los
+    scheduleTelemetry();
+    scheduleBaudCheck();
+    scheduler.run(millis());
+
+    profiler.record(LoopProfiler::LOOP, loopStart);
+
+    // ========================================
+    // 4. DORMIR ATÉ O PRÓXIMO PRAZO
+    // ========================================
+    // Ainda há bytes na Serial ou comandos no leitor: volta já
+    if (status != CommandReader::NONE || Serial.available() > 0) {
+        return;
+    }
+    // Senão dorme até o próximo prazo (no máximo LOOP_MAX_SLEEP), ou até a
+    // Serial ou a tarefa das missões acordarem a tarefa antes disso
+    unsigned long wait = scheduler.timeUntilNext(millis(), LOOP_MAX_SLEEP);
+    if (wait > 0) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
     }
 }
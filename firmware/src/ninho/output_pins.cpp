@@ -0,0 +1,72 @@
+#include "output_pins.h"
+#include <soc/gpio_struct.h>
+#include <atomic>
+
+namespace OutputPins {
+
+// Um bit por GPIO: o nível guardado, se ele ainda vale e se o pino está
+// com o LEDC
+static std::atomic<uint32_t> levels(0);
+static std::atomic<uint32_t> known(0);
+static std::atomic<uint32_t> ledcPins(0);
+
+// Pino no byte alto e frequência embaixo (0 = mudo)
+static const uint32_t TONE_UNKNOWN = 0xFFFFFFFF;
+static std::atomic<uint32_t> toneState(TONE_UNKNOWN);
+
+// Devolve ao GPIO os pinos que estavam com o LEDC. Só acontece na primeira
+// escrita digital depois de um analogWrite(); as seguintes não passam daqui.
+static void reclaim(uint32_t pins) {
+    uint32_t taken = ledcPins.fetch_and(~pins) & pins;
+    for (uint8_t pin = 0; taken; pin++, taken >>= 1) {
+        if (taken & 1) {
+            ledcDetachPin(pin);
+            pinMode(pin, OUTPUT);
+        }
+    }
+}
+
+void apply(uint32_t setMask, uint32_t clearMask) {
+    if (ledcPins.load() & (setMask | clearMask)) reclaim(setMask | clearMask);
+
+    uint32_t unknown = ~known.fetch_or(setMask | clearMask);
+    uint32_t before = levels.fetch_or(setMask);
+    levels.fetch_and(~clearMask);
+
+    uint32_t rising = setMask & (~before | unknown);
+    uint32_t falling = clearMask & (before | unknown);
+    if (rising) GPIO.out_w1ts = rising;
+    if (falling) GPIO.out_w1tc = falling;
+}
+
+uint8_t level(uint8_t pin) {
+    return (levels.load() & mask(pin)) ? HIGH : LOW;
+}
+
+void release(uint8_t pin) {
+    ledcPins.fetch_or(mask(pin));
+    known.fetch_and(~mask(pin));
+}
+
+bool released(uint8_t pin) {
+    return (ledcPins.load() & mask(pin)) != 0;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    if (duration > 0) {
+        toneState = TONE_UNKNOWN;
+        ::tone(pin, frequency, duration);
+        return;
+    }
+    uint32_t state = ((uint32_t)pin << 24) | (frequency & 0xFFFFFF);
+    if (toneState.exchange(state) == state) return;
+    ::tone(pin, frequency);
+}
+
+void noTone(uint8_t pin) {
+    uint32_t state = (uint32_t)pin << 24;
+    if (toneState.exchange(state) == state) return;
+    ::noTone(pin);
+}
+
+}  // namespace OutputPins
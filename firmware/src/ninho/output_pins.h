@@ -0,0 +1,53 @@
+#ifndef OUTPUT_PINS_H
+#define OUTPUT_PINS_H
+
+#include <Arduino.h>
+#include "hardware_map.h"
+
+// Saídas do hardware_map.h com o último estado escrito guardado: o
+// hardware só é tocado quando algo muda. Missões que repetem o mesmo nível
+// a cada tick (LED aceso, campainha, toggle) custam só uma comparação.
+//
+// Os níveis digitais vão direto para os registradores W1TS/W1TC do GPIO,
+// vários pinos numa única escrita (apply). Cada registrador cobre os GPIOs
+// 0 a 31, então as saídas digitais precisam estar nessa faixa.
+//
+// Pode ser chamado pela tarefa das missões e pela do esp_timer (pisca,
+// melodia): o estado guardado é atômico. Cada pino tem um dono por vez
+// (a missão ou o seu OutputWaveform), então não há duas escritas
+// disputando o mesmo pino.
+namespace OutputPins {
+
+constexpr uint32_t mask(uint8_t pin) { return 1UL << pin; }
+
+static_assert(PIN_LED < 32 && PIN_LED_2 < 32 && PIN_BUZZER < 32,
+              "As saidas devem estar nos GPIOs 0 a 31 (registradores W1TS/W1TC)");
+
+// Liga os pinos de setMask e desliga os de clearMask (máscaras disjuntas)
+void apply(uint32_t setMask, uint32_t clearMask);
+
+inline void write(uint8_t pin, uint8_t level) {
+    if (level) apply(mask(pin), 0);
+    else apply(0, mask(pin));
+}
+
+// Último nível escrito (só vale se o pino não foi liberado depois)
+uint8_t level(uint8_t pin);
+
+// O LEDC (analogWrite) passou a dirigir o pino pela matriz do GPIO: o nível
+// guardado deixa de valer e os registradores W1TS/W1TC não chegam mais ao
+// pino. A próxima escrita digital o devolve ao GPIO (ledcDetachPin +
+// pinMode) antes de escrever.
+void release(uint8_t pin);
+
+// O pino está com o LEDC (release() sem escrita digital depois)
+bool released(uint8_t pin);
+
+// tone()/noTone(): o core toca um pino por vez, então basta guardar o tom
+// atual. Um tom com duração termina sozinho e não é guardado.
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+}  // namespace OutputPins
+
+#endif
@@ -0,0 +1,119 @@
+#include "output_waveform.h"
+#include "output_pins.h"
+
+void OutputWaveform::begin(uint8_t pin) {
+    outputPin = pin;
+
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "waveform";
+    esp_timer_create(&args, &timer);
+}
+
+// Rearma para um instante absoluto: o atraso de um callback não passa para
+// o seguinte
+void OutputWaveform::schedule(int64_t at) {
+    int64_t wait = at - esp_timer_get_time();
+    esp_timer_start_once(timer, wait > 1 ? wait : 1);
+}
+
+void OutputWaveform::blink(uint32_t periodMs, uint8_t startLevel) {
+    uint32_t periodUs = periodMs * 1000UL;
+
+    if (mode == BLINK) {
+        if (periodUs == period) return;
+        esp_timer_stop(timer);
+        deadline += (int64_t)periodUs - period;
+        period = periodUs;
+        schedule(deadline);
+        return;
+    }
+
+    stop();
+    period = periodUs;
+    level = startLevel ? HIGH : LOW;
+    OutputPins::write(outputPin, level);
+    deadline = esp_timer_get_time() + period;
+    mode = BLINK;
+    schedule(deadline);
+}
+
+// O duty guardado só vale enquanto o pino está com o LEDC: uma escrita
+// digital depois dele (pisca, SET_OUT) o devolve ao GPIO
+void OutputWaveform::fade(uint8_t target, uint32_t durationMs) {
+    if (mode == FADE ? target == toDuty
+                     : mode == NONE && target == duty && OutputPins::released(outputPin)) return;
+
+    if (durationMs == 0) {
+        write(target);
+        return;
+    }
+
+    stop();
+
+    fromDuty = duty;
+    toDuty = target;
+    fadeStart = esp_timer_get_time();
+    fadeLength = durationMs * 1000UL;
+    deadline = fadeStart;
+    mode = FADE;
+    onTimer(this);
+}
+
+void OutputWaveform::write(uint8_t value) {
+    if (mode == NONE && value == duty && OutputPins::released(outputPin)) return;
+    stop();
+    setDuty(value);
+}
+
+// O pino passa ao LEDC só na primeira vez; os passos seguintes só mudam o duty
+void OutputWaveform::setDuty(uint8_t value) {
+    duty = value;
+    analogWrite(outputPin, duty);
+    if (!OutputPins::released(outputPin)) OutputPins::release(outputPin);
+}
+
+// A tarefa do esp_timer tem prioridade acima da tarefa das missões e roda no
+// mesmo núcleo: quando a missão chega aqui, nenhum callback está no meio
+void OutputWaveform::stop() {
+    if (mode == NONE) return;
+    mode = NONE;
+    esp_timer_stop(timer);
+}
+
+// Roda na tarefa do esp_timer (ou, no primeiro passo do fade, em quem chamou)
+void OutputWaveform::onTimer(void* arg) {
+    OutputWaveform& wave = *static_cast<OutputWaveform*>(arg);
+
+    switch (wave.mode) {
+        case BLINK:
+            wave.level = wave.level ? LOW : HIGH;
+            OutputPins::write(wave.outputPin, wave.level);
+            wave.deadline += wave.period;
+            wave.schedule(wave.deadline);
+            break;
+
+        case FADE: {
+            // Duty calculado pelo tempo desde o início, não por incrementos
+            int64_t elapsed = esp_timer_get_time() - wave.fadeStart;
+            if (elapsed >= wave.fadeLength) {
+                wave.setDuty(wave.toDuty);
+                wave.mode = NONE;
+                break;
+            }
+
+            int next = wave.fromDuty + ((int)wave.toDuty - wave.fromDuty) * elapsed / (int64_t)wave.fadeLength;
+            if (next != wave.duty) wave.setDuty(next);
+            // O último passo cai exatamente no fim do fade
+            wave.deadline += FADE_STEP_MS * 1000UL;
+            if (wave.deadline > wave.fadeStart + wave.fadeLength) wave.deadline = wave.fadeStart + wave.fadeLength;
+            wave.schedule(wave.deadline);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef OUTPUT_WAVEFORM_H
+#define OUTPUT_WAVEFORM_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+
+// Formas de onda de uma saída, executadas fora das missões.
+// A missão só declara "pisca a cada P ms" ou "vai ao duty D em T ms"; as
+// trocas do pino acontecem nos callbacks de um esp_timer de disparo único,
+// rearmado a cada vez para um instante absoluto (anterior + período). Não há
+// trabalho a cada tick e o pisca não acumula atraso, ao contrário de
+// "if (now - last >= P) last = now", que desliza o atraso de cada passada.
+class OutputWaveform {
+public:
+    // Intervalo entre os passos de duty de um fade
+    static const uint32_t FADE_STEP_MS = 10;
+
+    void begin(uint8_t pin);
+
+    uint8_t pin() const { return outputPin; }
+
+    // Escreve "startLevel" agora e inverte o pino a cada "periodMs".
+    // Se já estiver piscando, só troca o período, contado da última troca
+    // (repetir a mesma chamada a cada tick não muda nada).
+    void blink(uint32_t periodMs, uint8_t startLevel);
+
+    // Leva o duty da analogWrite(), a partir do último escrito aqui, até
+    // "duty" em "durationMs". Repetir o mesmo fade não o reinicia.
+    void fade(uint8_t duty, uint32_t durationMs);
+
+    // Para a forma de onda e escreve o duty agora (base do próximo fade).
+    // O mesmo duty já no pino não é escrito de novo (a Missão 3 e o PWM_POT
+    // chamam a cada tick)
+    void write(uint8_t duty);
+
+    // Para a forma de onda; o pino fica como está (quem chama o ajusta)
+    void stop();
+
+    bool blinking() const { return mode == BLINK; }
+
+private:
+    enum Mode : uint8_t { NONE, BLINK, FADE };
+
+    static void onTimer(void* arg);
+    void schedule(int64_t at);
+    void setDuty(uint8_t value);
+
+    uint8_t outputPin = 0;
+    esp_timer_handle_t timer = nullptr;
+
+    // Escrito pela tarefa das missões; o callback confere antes de agir
+    std::atomic<uint8_t> mode{NONE};
+
+    // Instante (esp_timer_get_time) do próximo disparo ou do início do fade
+    int64_t deadline = 0;
+
+    // Pisca
+    uint32_t period = 0;   // micros
+    uint8_t level = LOW;
+
+    // Fade
+    uint8_t fromDuty = 0;
+    uint8_t toDuty = 0;
+    uint8_t duty = 0;      // Último duty escrito
+    int64_t fadeStart = 0;
+    uint32_t fadeLength = 0;   // micros
+};
+
+#endif
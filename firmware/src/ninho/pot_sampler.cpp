@@ -0,0 +1,127 @@
+#include "pot_sampler.h"
+#include <driver/adc.h>
+
+// Bytes lidos do DMA por vez e tamanho do buffer mantido pelo driver
+// (cada conversão ocupa 2 bytes no ESP32: ~25ms de folga a 20 kHz)
+static const uint32_t DMA_FRAME_BYTES = 256;
+static const uint32_t DMA_BUFFER_BYTES = 1024;
+
+bool PotSampler::begin(uint8_t potPin) {
+    pin = potPin;
+    channel = digitalPinToAnalogChannel(pin);
+
+    // O modo contínuo do ESP32 só atende o ADC1 (canais 0 a 7)
+    if (channel < 0 || channel > 7) {
+        return false;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = DMA_BUFFER_BYTES;
+    init.conv_num_each_intr = DMA_FRAME_BYTES;
+    init.adc1_chan_mask = BIT(channel);
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK) {
+        return false;
+    }
+
+    // Mesma atenuação da analogRead(): faixa completa de 0 a 3,3V
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = channel;
+    pattern.unit = 0;  // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = true;  // Obrigatório no ESP32
+    config.conv_limit_num = 250;
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = SAMPLE_RATE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    continuous = true;
+    return true;
+}
+
+void PotSampler::poll() {
+    if (!continuous) {
+        addDecimated(analogRead(pin));
+        updateStats();
+        return;
+    }
+
+    uint8_t bytes[DMA_FRAME_BYTES];
+    uint32_t length = 0;
+
+    // Timeout zero: só copia o que já está pronto. ESP_ERR_INVALID_STATE
+    // indica que o buffer do driver transbordou, mas os dados lidos valem.
+    for (uint32_t reads = 0; reads < DMA_BUFFER_BYTES / DMA_FRAME_BYTES; reads++) {
+        esp_err_t result = adc_digi_read_bytes(bytes, sizeof(bytes), &length, 0);
+        if ((result != ESP_OK && result != ESP_ERR_INVALID_STATE) || length == 0) {
+            break;
+        }
+
+        for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= length; i += sizeof(adc_digi_output_data_t)) {
+            const adc_digi_output_data_t* data = reinterpret_cast<const adc_digi_output_data_t*>(&bytes[i]);
+            if (data->type1.channel == channel) {
+                addSample(data->type1.data);
+            }
+        }
+
+        if (length < sizeof(bytes)) {
+            break;
+        }
+    }
+
+    updateStats();
+}
+
+void PotSampler::addSample(uint16_t sample) {
+    blockSum += sample;
+    blockCount++;
+
+    // Média de DECIMATION amostras: reduz o ruído do ADC do ESP32
+    if (blockCount == DECIMATION) {
+        addDecimated(blockSum / DECIMATION);
+        blockSum = 0;
+        blockCount = 0;
+    }
+}
+
+void PotSampler::addDecimated(uint16_t value) {
+    if (windowCount == WINDOW) {
+        windowSum -= window[windowNext];
+    } else {
+        windowCount++;
+    }
+    window[windowNext] = value;
+    windowSum += value;
+    windowNext = (windowNext + 1) % WINDOW;
+
+    current.value = value;
+    windowChanged = true;
+}
+
+// Uma varredura da janela por poll(), mesmo que um lote do DMA tenha
+// trazido várias leituras decimadas
+void PotSampler::updateStats() {
+    if (!windowChanged) return;
+    windowChanged = false;
+
+    uint16_t low = window[0];
+    uint16_t high = window[0];
+    for (uint8_t i = 1; i < windowCount; i++) {
+        if (window[i] < low) low = window[i];
+        if (window[i] > high) high = window[i];
+    }
+
+    current.min = low;
+    current.max = high;
+    current.mean = windowSum / windowCount;
+}
@@ -0,0 +1,60 @@
+#ifndef POT_SAMPLER_H
+#define POT_SAMPLER_H
+
+#include <Arduino.h>
+
+// Leitura do potenciômetro já filtrada
+struct PotReading {
+    uint16_t value;  // Média do último bloco de amostras (0 a 4095)
+    uint16_t min;    // Menor valor na janela recente
+    uint16_t max;    // Maior valor na janela recente
+    uint16_t mean;   // Média da janela recente
+};
+
+// Amostragem contínua do potenciômetro pelo ADC em modo DMA.
+// O hardware enche um buffer em segundo plano; poll() apenas consome o que
+// já chegou (sem esperar), faz a média de blocos de amostras (oversampling
+// + decimação) e mantém estatísticas de uma janela curta, que chegam às
+// missões e à telemetria pelo InputSnapshot (potMin, potMax, potMean).
+class PotSampler {
+public:
+    // Taxa do ADC e fator de decimação: 20 kHz / 32 = 625 leituras por segundo
+    static const uint32_t SAMPLE_RATE_HZ = 20000;
+    static const uint16_t DECIMATION = 32;
+
+    // Janela das estatísticas (em leituras já decimadas): ~100ms
+    static const uint8_t WINDOW = 64;
+
+    // Retorna false se o modo contínuo não puder ser usado; nesse caso
+    // poll() cai para uma analogRead() por chamada
+    bool begin(uint8_t pin);
+
+    // Processa as amostras que o DMA produziu desde a última chamada
+    void poll();
+
+    const PotReading& reading() const { return current; }
+
+private:
+    void addSample(uint16_t sample);
+    void addDecimated(uint16_t value);
+    void updateStats();
+
+    uint8_t pin = 0;
+    int8_t channel = -1;
+    bool continuous = false;
+
+    // Bloco de decimação em andamento
+    uint32_t blockSum = 0;
+    uint16_t blockCount = 0;
+
+    // Janela circular de leituras decimadas
+    uint16_t window[WINDOW] = {};
+    uint8_t windowNext = 0;
+    uint8_t windowCount = 0;
+    uint32_t windowSum = 0;
+    bool windowChanged = false;
+
+    PotReading current = {};
+};
+
+#endif
@@ -1,61 +1,338 @@
 #include "protocol.h"
 
-Protocol::Command Protocol::parse(const String& json) {
+const char* const Protocol::COMMAND_NAMES[COMMAND_COUNT] = {
+    "",
+    "SET_ID",
+    "SET_MISSION",
+    "GET_STATUS",
+    "GET_VERSION",
+    "SET_FORMAT",
+    "SET_TELEMETRY",
+    "SET_CAPTURE",
+    "GET_METRICS",
+    "SET_BAUD",
+    "PING",
+    "LOAD_MISSION",
+    "SET_PARAM",
+    "PLAY",
+};
+
+// Poucos comandos e nomes curtos: a busca linear custa menos que um hash
+static Protocol::CommandType commandType(const char* name) {
+    for (uint8_t i = 1; i < Protocol::COMMAND_COUNT; i++) {
+        if (strcmp(name, Protocol::COMMAND_NAMES[i]) == 0) {
+            return static_cast<Protocol::CommandType>(i);
+        }
+    }
+    return Protocol::UNKNOWN_COMMAND;
+}
+
+Protocol::Command Protocol::parse(char* data, size_t length) {
     Command cmd;
+    cmd.type = UNKNOWN_COMMAND;
     cmd.valid = false;
 
     StaticJsonDocument<512> doc;
-    DeserializationError error = deserializeJson(doc, json);
+    DeserializationError error = format == MSGPACK
+        ? deserializeMsgPack(doc, data, length)
+        : deserializeJson(doc, data, length);
 
     if (error) {
         return cmd;
     }
 
-    cmd.type = doc["type"].as<String>();
-    if (doc.containsKey("userId")) cmd.userId = doc["userId"].as<String>();
-    if (doc.containsKey("missionId")) cmd.missionId = doc["missionId"].as<String>();
+    // Com o buffer mutável, o ArduinoJson deixa os textos no lugar:
+    // os ponteiros abaixo continuam valendo depois que o doc sai de escopo
+    cmd.type = commandType(doc["type"] | "");
+    cmd.userId = doc["userId"] | "";
+    cmd.missionId = doc["missionId"] | "";
+    cmd.format = doc["format"] | "";
+    cmd.mode = doc["mode"] | "";
+    cmd.framing = doc["framing"] | "";
+    cmd.data = doc["data"] | "";
+    cmd.param = doc["param"] | "";
+    cmd.rtttl = doc["rtttl"] | "";
+    cmd.intervalMs = doc["intervalMs"] | -1L;
+    cmd.heartbeatMs = doc["heartbeatMs"] | -1L;
+    cmd.deadband = doc["deadband"] | -1L;
+    cmd.rateHz = doc["rateHz"] | -1L;
+    cmd.batch = doc["batch"] | -1L;
+    cmd.baud = doc["baud"] | -1L;
+    cmd.offset = doc["offset"] | -1L;
+    cmd.size = doc["size"] | -1L;
+    cmd.value = doc["value"] | -1L;
+    cmd.seq = doc["seq"] | -1L;
+    JsonVariantConst extended = doc["extended"];
+    cmd.extended = extended.is<bool>() ? extended.as<bool>() : -1;
+    cmd.reset = doc["reset"] | false;
+    cmd.loop = doc["loop"] | true;
     cmd.valid = true;
 
     return cmd;
 }
 
-void Protocol::sendTelemetry(const String& userId, const String& missionId, int ledState, int btnState, int potValue) {
-    StaticJsonDocument<256> doc;
+void Protocol::sendTelemetry(const char* userId, uint32_t userGeneration, MissionId mission,
+                             int ledState, const InputSnapshot& inputs, bool extended) {
+    const char* missionId = MissionRegistry::name(mission);
+
+    // Telemetria automática em JSON: só os números são escritos no esqueleto
+    // pronto. Com "seq" (GET_STATUS), usa o caminho genérico.
+    if (format == JSON && replySeq < 0) {
+        uint32_t start = LoopProfiler::now();
+        telemetry.prepare(userId, userGeneration, missionId);
+        size_t body = telemetry.encode(reinterpret_cast<char*>(payload()), payloadRoom(),
+                                       ledState, inputs, extended);
+        if (body > 0) {
+            sendPayload(body, start);
+            return;
+        }
+    }
+
+    // Automática em MessagePack: array posicional (COMPACT_TELEMETRY), com a
+    // missão pelo índice e sem o userId, que o host definiu e o GET_STATUS
+    // devolve
+    if (format == MSGPACK && replySeq < 0) {
+        StaticJsonDocument<JSON_ARRAY_SIZE(9)> doc;
+        doc.add(COMPACT_TELEMETRY);
+        doc.add(static_cast<uint8_t>(mission));
+        doc.add(ledState);
+        doc.add(inputs.btn);
+        doc.add(inputs.pot);
+        if (extended) {
+            doc.add(inputs.potMin);
+            doc.add(inputs.potMax);
+            doc.add(inputs.potMean);
+            doc.add(inputs.seq);
+        }
+        send(doc);
+        return;
+    }
+
+    // type, userId, missionId, readings, tick e seq; os textos não são copiados
+    StaticJsonDocument<JSON_OBJECT_SIZE(6) + JSON_OBJECT_SIZE(6)> doc;
     doc["type"] = "TELEMETRY";
     doc["userId"] = userId;
     doc["missionId"] = missionId;
     
     JsonObject readings = doc.createNestedObject("readings");
     readings["led"] = ledState;
-    readings["btn"] = btnState;
-    readings["pot"] = potValue;
+    readings["btn"] = inputs.btn;
+    readings["pot"] = inputs.pot;
+    if (extended) {
+        readings["potMin"] = inputs.potMin;
+        readings["potMax"] = inputs.potMax;
+        readings["potMean"] = inputs.potMean;
+        doc["tick"] = inputs.seq;
+    }
 
-    serializeJson(doc, Serial);
-    Serial.println();
+    send(doc);
 }
 
-void Protocol::sendAck(const String& commandType) {
+void Protocol::sendAck(CommandType command) {
     StaticJsonDocument<128> doc;
     doc["type"] = "ACK";
-    doc["command"] = commandType;
-    serializeJson(doc, Serial);
-    Serial.println();
+    doc["command"] = COMMAND_NAMES[command];
+    doc["code"] = STATUS_OK;
+    send(doc);
 }
 
-void Protocol::sendError(const String& message) {
+void Protocol::sendError(Status code, const char* message) {
     StaticJsonDocument<128> doc;
     doc["type"] = "ERROR";
+    doc["code"] = code;
     doc["message"] = message;
-    serializeJson(doc, Serial);
-    Serial.println();
+    send(doc);
 }
 
-void Protocol::sendVersion(const String& version, int build, const String& date) {
+void Protocol::sendNak() {
+    StaticJsonDocument<64> doc;
+    doc["type"] = "NAK";
+    doc["code"] = STATUS_BAD_FRAME;
+    send(doc);
+}
+
+void Protocol::sendVersion(const char* version, int build, const char* date) {
     StaticJsonDocument<256> doc;
     doc["type"] = "VERSION";
     doc["version"] = version;
     doc["build"] = build;
     doc["date"] = date;
-    serializeJson(doc, Serial);
-    Serial.println();
+    send(doc);
+}
+
+void Protocol::sendBaud(uint32_t baud) {
+    StaticJsonDocument<128> doc;
+    doc["type"] = "ACK";
+    doc["command"] = COMMAND_NAMES[SET_BAUD];
+    doc["code"] = STATUS_OK;
+    doc["baud"] = baud;
+    send(doc);
+}
+
+void Protocol::sendPong() {
+    StaticJsonDocument<64> doc;
+    doc["type"] = "PONG";
+    send(doc);
+}
+
+void Protocol::sendSamples(const CaptureSample* samples, size_t count) {
+    StaticJsonDocument<JSON_OBJECT_SIZE(6) + 3 * JSON_ARRAY_SIZE(MAX_SAMPLES)> doc;
+
+    // Instantes relativos à primeira amostra, em microssegundos
+    uint32_t t0 = count > 0 ? samples[0].time : 0;
+
+    // Em MessagePack, os mesmos campos num array posicional (COMPACT_SAMPLES)
+    JsonArray time, levels, pot;
+    if (format == MSGPACK) {
+        doc.add(COMPACT_SAMPLES);
+        doc.add(t0);
+        time = doc.createNestedArray();
+        levels = doc.createNestedArray();
+        pot = doc.createNestedArray();
+    } else {
+        doc["type"] = "SAMPLES";
+        doc["t0"] = t0;
+        time = doc.createNestedArray("t");
+        levels = doc.createNestedArray("io");
+        pot = doc.createNestedArray("pot");
+    }
+    for (size_t i = 0; i < count && i < MAX_SAMPLES; i++) {
+        time.add(samples[i].time - t0);
+        levels.add(samples[i].levels);
+        pot.add(samples[i].pot);
+    }
+
+    send(doc);
+}
+
+void Protocol::sendMetrics(const LoopProfiler& metrics) {
+    StaticJsonDocument<JSON_OBJECT_SIZE(6) + JSON_OBJECT_SIZE(LoopProfiler::STAGE_COUNT)
+        + LoopProfiler::STAGE_COUNT * (JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(LoopProfiler::BUCKETS))> doc;
+    doc["type"] = "METRICS";
+    doc["cpuMHz"] = metrics.cpuMHz();
+    doc["missed"] = metrics.missedDeadlines();
+    doc["overflows"] = metrics.overflowedMessages();
+
+    JsonObject stages = doc.createNestedObject("stages");
+    for (uint8_t i = 0; i < LoopProfiler::STAGE_COUNT; i++) {
+        LoopProfiler::Stage stage = static_cast<LoopProfiler::Stage>(i);
+        const LoopProfiler::Histogram& histogram = metrics.histogram(stage);
+
+        JsonObject entry = stages.createNestedObject(LoopProfiler::name(stage));
+        entry["n"] = histogram.count;
+        entry["max"] = histogram.maxMicros;
+
+        // Omite as faixas vazias do fim para encurtar a mensagem
+        uint8_t used = LoopProfiler::BUCKETS;
+        while (used > 0 && histogram.buckets[used - 1] == 0) used--;
+        JsonArray buckets = entry.createNestedArray("h");
+        for (uint8_t b = 0; b < used; b++) {
+            buckets.add(histogram.buckets[b]);
+        }
+    }
+
+    send(doc);
+}
+
+uint8_t* Protocol::payload() {
+    if (framing == COBS) return txBuffer + COBS_HEADROOM;
+    return format == MSGPACK ? txBuffer + 2 : txBuffer;
+}
+
+size_t Protocol::payloadRoom() const {
+    // COBS: reserva o CRC e o 0x00 final; os outros: o prefixo ou o "\r\n".
+    // O serializeJson ainda escreve um '\0' depois do conteúdo.
+    if (framing == COBS) return TX_BUFFER_SIZE - COBS_HEADROOM - FrameCodec::CRC_SIZE - 1;
+    return TX_BUFFER_SIZE - 2;
+}
+
+// Serializa uma única vez, direto no buffer do quadro, e faz uma só escrita:
+// o driver da UART copia o quadro para o seu buffer circular e a interrupção
+// da UART o esvazia enquanto o próximo quadro é montado. Como a escrita é
+// uma chamada só, quadros de tarefas diferentes nunca se misturam.
+void Protocol::send(JsonDocument& doc) {
+    if (replySeq >= 0) doc["seq"] = replySeq;
+
+    uint32_t start = LoopProfiler::now();
+    size_t room = payloadRoom();
+    size_t body = format == MSGPACK
+        ? serializeMsgPack(doc, payload(), room)
+        : serializeJson(doc, reinterpret_cast<char*>(payload()), room);
+
+    // Sem espaço, o ArduinoJson corta a mensagem e devolve o que escreveu: a
+    // que enche o buffer inteiro (no JSON, sem lugar para o '\0') foi cortada
+    if (body >= room) body = 0;
+    sendPayload(body, start);
+}
+
+void Protocol::setReplySeq(long seq, uint16_t command) {
+    replySeq = seq;
+    if (seq < 0) {
+        currentReply = nullptr;
+        return;
+    }
+
+    currentReply = &replies[nextReply];
+    nextReply = (nextReply + 1) % REPLY_SLOTS;
+    currentReply->seq = seq;
+    currentReply->command = command;
+    currentReply->length = 0;
+}
+
+bool Protocol::resendReply(long seq, uint16_t command) {
+    for (const Reply& reply : replies) {
+        if (reply.seq != seq || reply.command != command || reply.length == 0) continue;
+
+        uint32_t start = LoopProfiler::now();
+        memcpy(payload(), reply.data, reply.length);
+        sendPayload(reply.length, start);
+        return true;
+    }
+    return false;
+}
+
+void Protocol::sendPayload(size_t body, uint32_t start) {
+    // Nada de quadro cortado ou vazio: o host recebe um ERROR no lugar. Ele
+    // não fica guardado, então o comando reenviado é executado de novo.
+    if (body == 0) {
+        if (profiler) profiler->overflowed();
+
+        Reply* reply = currentReply;
+        currentReply = nullptr;
+        sendError(STATUS_OVERFLOW, "Reply too long");
+        currentReply = reply;
+        if (reply) reply->length = 0;
+        return;
+    }
+
+    // Guarda a resposta antes do enquadramento (o COBS escreve por cima)
+    if (currentReply) {
+        bool fits = body <= REPLY_SIZE;
+        if (fits) memcpy(currentReply->data, payload(), body);
+        currentReply->length = fits ? body : 0;
+    }
+
+    size_t length;
+    if (framing == COBS) {
+        // Conteúdo + CRC depois da folga, depois codificado para o início
+        uint8_t* content = payload();
+        uint16_t crc = FrameCodec::crc16(content, body);
+        content[body++] = (uint8_t)(crc >> 8);
+        content[body++] = (uint8_t)(crc & 0xFF);
+        length = FrameCodec::encode(content, body, txBuffer);
+        txBuffer[length++] = 0;
+    } else if (format == MSGPACK) {
+        txBuffer[0] = (uint8_t)(body >> 8);
+        txBuffer[1] = (uint8_t)(body & 0xFF);
+        length = body + 2;
+    } else {
+        length = body;
+        txBuffer[length++] = '\r';
+        txBuffer[length++] = '\n';
+    }
+    if (profiler) profiler->record(LoopProfiler::SERIALIZE, start);
+
+    start = LoopProfiler::now();
+    Serial.write(txBuffer, length);
+    if (profiler) profiler->record(LoopProfiler::WRITE, start);
 }
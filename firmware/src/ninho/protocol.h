@@ -3,21 +3,196 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "frame_codec.h"
+#include "loop_profiler.h"
+#include "task_messages.h"
+#include "telemetry_encoder.h"
 
 class Protocol {
 public:
+    // Codificação das mensagens na Serial (a mesma nos dois sentidos)
+    // JSON: uma linha de texto por mensagem
+    // MSGPACK: MessagePack precedido de 2 bytes de tamanho (big-endian)
+    enum Format {
+        JSON,
+        MSGPACK
+    };
+
+    // Enquadramento opcional por cima do formato (SET_FORMAT "framing")
+    // PLAIN: o de cada formato, sem verificação
+    // COBS: conteúdo + CRC-16 em COBS, terminado em 0x00 (frame_codec.h)
+    enum Framing {
+        PLAIN,
+        COBS
+    };
+
+    // Comandos aceitos (campo "type"), na mesma ordem de COMMAND_NAMES
+    enum CommandType : uint8_t {
+        UNKNOWN_COMMAND,
+        SET_ID,
+        SET_MISSION,
+        GET_STATUS,
+        GET_VERSION,
+        SET_FORMAT,
+        SET_TELEMETRY,
+        SET_CAPTURE,
+        GET_METRICS,
+        SET_BAUD,
+        PING,
+        LOAD_MISSION,
+        SET_PARAM,
+        PLAY,
+        COMMAND_COUNT
+    };
+
+    static const char* const COMMAND_NAMES[COMMAND_COUNT];
+
+    // Quadros automáticos em MSGPACK (telemetria sem "seq" e amostras): um
+    // array posicional, sem os nomes dos campos, em vez do mapa do JSON. O
+    // primeiro elemento diz qual quadro é; o esquema está no README e em
+    // frontend/lib/mensagens.ts, que o decodifica
+    enum CompactFrame : uint8_t {
+        COMPACT_TELEMETRY = 1,  // [1, missão (índice de MissionId), led, btn, pot]
+                                // + [potMin, potMax, potMean, tick] com extended
+        COMPACT_SAMPLES = 2     // [2, t0, [t...], [io...], [pot...]]
+    };
+
+    // Código de resultado de cada comando, enviado no campo "code" do ACK
+    // (sempre STATUS_OK) e do ERROR
+    enum Status : uint8_t {
+        STATUS_OK = 0,
+        STATUS_UNKNOWN_COMMAND = 1,    // "type" desconhecido
+        STATUS_INVALID_ARGUMENT = 2,   // Campo ausente ou fora da faixa
+        STATUS_UNKNOWN_MISSION = 3,    // "missionId" desconhecido
+        STATUS_BUSY = 4,               // Fila da tarefa das missões cheia, tente de novo
+        STATUS_TOO_LONG = 5,           // Linha/quadro maior que o limite (sem "seq")
+        STATUS_BAD_FRAME = 6,          // Quadro corrompido (NAK, sem "seq"): reenvie o comando
+        STATUS_OVERFLOW = 7            // A resposta não coube no quadro de saída
+    };
+
+    // Comando já analisado, sem nenhuma alocação no heap: os textos apontam
+    // para dentro do buffer recebido e valem "" quando o campo não veio
     struct Command {
-        String type;
-        String userId;
-        String missionId;
+        CommandType type;
+        const char* userId;
+        const char* missionId;
+        const char* format;
+        const char* mode;
+        const char* framing;
+        const char* data;   // LOAD_MISSION: pedaço do programa em base64
+                            // PLAY: notas no formato binário, em base64
+        const char* param;  // SET_PARAM: nome do parâmetro
+        const char* rtttl;  // PLAY: melodia em RTTTL
+        long intervalMs;    // -1 quando ausente
+        long heartbeatMs;   // -1 quando ausente
+        long deadband;      // -1 quando ausente
+        long rateHz;        // -1 quando ausente
+        long batch;         // -1 quando ausente
+        long baud;          // -1 quando ausente
+        long offset;        // -1 quando ausente
+        long size;          // -1 quando ausente
+        long value;         // -1 quando ausente
+        long seq;           // -1 quando ausente; devolvido nas respostas
+        int8_t extended;    // SET_TELEMETRY: 1 ou 0, -1 quando ausente
+        bool reset;
+        bool loop;          // PLAY: true quando ausente
         bool valid;
     };
 
-    Command parse(const String& json);
-    void sendTelemetry(const String& userId, const String& missionId, int ledState, int btnState, int potValue);
-    void sendAck(const String& commandType);
-    void sendError(const String& message);
-    void sendVersion(const String& version, int build, const String& date);
+    // Analisa o comando no próprio buffer (modo "zero-copy" do ArduinoJson).
+    // O buffer é modificado e precisa continuar válido enquanto o comando for usado.
+    Command parse(char* data, size_t length);
+    // userGeneration é UserIdStore::generation(): o JSON só é remontado
+    // quando ele ou a missão mudam. As entradas vêm da leitura enviada; com
+    // extended, vão também potMin/potMax/potMean e o "tick"
+    // (InputSnapshot::seq).
+    void sendTelemetry(const char* userId, uint32_t userGeneration, MissionId mission,
+                       int ledState, const InputSnapshot& inputs, bool extended);
+    void sendAck(CommandType command);
+    void sendError(Status code, const char* message);
+
+    // Pede ao host que reenvie o comando: o quadro recebido estava corrompido
+    // (CRC errado, COBS inválido ou, sem enquadramento, conteúdo ilegível)
+    void sendNak();
+    void sendVersion(const char* version, int build, const char* date);
+
+    // ACK do SET_BAUD com a velocidade escolhida pela placa
+    void sendBaud(uint32_t baud);
+    void sendPong();
+
+    // Envia um lote de amostras da captura em alta taxa
+    // Maior lote aceito por quadro
+    static const size_t MAX_SAMPLES = 32;
+    void sendSamples(const CaptureSample* samples, size_t count);
+
+    // Envia os histogramas do perfilador (GET_METRICS)
+    void sendMetrics(const LoopProfiler& metrics);
+
+    // Mede a serialização e a escrita de cada mensagem (opcional)
+    void setProfiler(LoopProfiler* value) { profiler = value; }
+
+    // Número de sequência do comando sendo atendido: enquanto for >= 0, toda
+    // mensagem enviada o leva no campo "seq", para o host casar a resposta
+    // com o pedido e manter vários comandos em andamento. A última mensagem
+    // fica guardada junto com command (CRC-16 do comando recebido).
+    void setReplySeq(long seq, uint16_t command = 0);
+
+    // Um NAK não diz qual comando se perdeu, então o host reenvia todos os
+    // que estão sem resposta, inclusive os já atendidos. Um comando com o
+    // mesmo "seq" e o mesmo conteúdo de um dos últimos REPLY_SLOTS não é
+    // executado de novo: a resposta guardada é reenviada e retorna true.
+    // Retorna false para um comando novo, ou se a resposta não coube em
+    // REPLY_SIZE (só as de leitura, como GET_METRICS): ele é executado.
+    bool resendReply(long seq, uint16_t command);
+
+    void setFormat(Format value) { format = value; }
+    Format getFormat() const { return format; }
+
+    void setFraming(Framing value) { framing = value; }
+    Framing getFraming() const { return framing; }
+
+private:
+    void send(JsonDocument& doc);
+
+    // Onde o conteúdo da mensagem é escrito no txBuffer, e quanto cabe
+    uint8_t* payload();
+    size_t payloadRoom() const;
+
+    // Fecha o quadro em volta dos body bytes já escritos em payload() e faz a
+    // escrita única; start é o início da serialização (perfilador).
+    // body 0 quer dizer que a mensagem não coube: em vez dela vai um ERROR
+    // STATUS_OVERFLOW, que não é guardado para reenvio.
+    void sendPayload(size_t body, uint32_t start);
+
+    Format format = JSON;
+    Framing framing = PLAIN;
+    long replySeq = -1;
+    LoopProfiler* profiler = nullptr;
+
+    // Últimas respostas enviadas (conteúdo antes do enquadramento, que é
+    // refeito no reenvio), em rodízio
+    static const size_t REPLY_SLOTS = 4;
+    static const size_t REPLY_SIZE = 256;
+    struct Reply {
+        long seq = -1;
+        uint16_t command = 0;
+        uint16_t length = 0;  // 0 = nada guardado (não coube ou sem resposta)
+        uint8_t data[REPLY_SIZE];
+    };
+    Reply replies[REPLY_SLOTS];
+    uint8_t nextReply = 0;
+    Reply* currentReply = nullptr;
+    TelemetryEncoder telemetry;
+
+    // Buffer de saída: o quadro é montado inteiro aqui (prefixo de tamanho ou
+    // terminador incluídos) e entregue à UART numa única escrita
+    // (o maior quadro é o de amostras)
+    static const size_t TX_BUFFER_SIZE = 1024;
+    uint8_t txBuffer[TX_BUFFER_SIZE];
+
+    // No enquadramento COBS o conteúdo é serializado depois desta folga e
+    // codificado para o início do mesmo buffer, sem um segundo buffer
+    static const size_t COBS_HEADROOM = FrameCodec::encodedSize(TX_BUFFER_SIZE) - TX_BUFFER_SIZE;
 };
 
 #endif
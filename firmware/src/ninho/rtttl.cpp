@@ -0,0 +1,135 @@
+#include "rtttl.h"
+
+namespace Rtttl {
+
+// Frequências da oitava 8 (C a B, com sustenidos); as outras são metades
+static const uint16_t OCTAVE_8[12] = { 4186, 4435, 4699, 4978, 5274, 5588, 5920, 6272, 6645, 7040, 7459, 7902 };
+
+// Semitom de cada letra (a a g) a partir de C
+static const uint8_t SEMITONES[7] = { 9, 11, 0, 2, 4, 5, 7 };
+
+static const uint8_t MIN_OCTAVE = 1;
+static const uint8_t MAX_OCTAVE = 8;
+
+static bool validDuration(long d) {
+    return d == 1 || d == 2 || d == 4 || d == 8 || d == 16 || d == 32;
+}
+
+static void skipSpaces(const char*& c) {
+    while (*c == ' ') c++;
+}
+
+// Número decimal (até 4 dígitos), ou -1 se não houver
+static long readNumber(const char*& c) {
+    if (*c < '0' || *c > '9') return -1;
+    long value = 0;
+    for (int digits = 0; *c >= '0' && *c <= '9'; c++) {
+        if (++digits > 4) return -1;
+        value = value * 10 + (*c - '0');
+    }
+    return value;
+}
+
+// Seção de padrões: "d=4,o=5,b=120" (qualquer ordem, todos opcionais)
+static bool parseDefaults(const char*& c, long& duration, long& octave, long& bpm) {
+    for (;;) {
+        skipSpaces(c);
+        if (*c == ':') return true;
+        if (*c == '\0') return false;
+
+        char key = *c++;
+        skipSpaces(c);
+        if (*c++ != '=') return false;
+        skipSpaces(c);
+        long value = readNumber(c);
+
+        switch (key) {
+            case 'd': duration = value; break;
+            case 'o': octave = value; break;
+            case 'b': bpm = value; break;
+            default: return false;
+        }
+        skipSpaces(c);
+        if (*c == ',') c++;
+        else if (*c != ':') return false;
+    }
+}
+
+size_t parse(const char* text, MelodyNote* notes, size_t capacity) {
+    // Padrões da especificação
+    long defaultDuration = 4;
+    long defaultOctave = 6;
+    long bpm = 63;
+
+    const char* c = strchr(text, ':');
+    if (c == nullptr) return 0;
+    c++;
+    if (!parseDefaults(c, defaultDuration, defaultOctave, bpm)) return 0;
+    c++;
+
+    if (!validDuration(defaultDuration) || defaultOctave < MIN_OCTAVE || defaultOctave > MAX_OCTAVE
+        || bpm < 1) {
+        return 0;
+    }
+
+    // Semibreve em ms: 4 batidas
+    uint32_t whole = 240000UL / bpm;
+    size_t count = 0;
+
+    for (;;) {
+        skipSpaces(c);
+        if (*c == '\0') break;
+        if (count >= capacity) return 0;
+
+        long duration = readNumber(c);
+        if (duration < 0) duration = defaultDuration;
+        if (!validDuration(duration)) return 0;
+
+        char letter = *c++ | 0x20;   // Minúscula
+        bool rest = letter == 'p';
+        if (!rest && (letter < 'a' || letter > 'g')) return 0;
+
+        uint8_t semitone = rest ? 0 : SEMITONES[letter - 'a'];
+        if (*c == '#') {
+            if (rest) return 0;
+            semitone++;
+            c++;
+        }
+
+        // O ponto aparece antes ou depois da oitava, conforme o editor
+        bool dotted = false;
+        if (*c == '.') {
+            dotted = true;
+            c++;
+        }
+        long octave = *c >= '0' && *c <= '9' ? *c++ - '0' : defaultOctave;
+        if (octave < MIN_OCTAVE || octave > MAX_OCTAVE) return 0;
+        if (*c == '.') {
+            dotted = true;
+            c++;
+        }
+
+        // B# é o C da oitava de cima
+        if (semitone == 12) {
+            semitone = 0;
+            octave++;
+            if (octave > MAX_OCTAVE) return 0;
+        }
+
+        uint32_t ms = whole / duration;
+        if (dotted) ms += ms / 2;
+        if (ms == 0 || ms > 0xFFFF) return 0;
+
+        notes[count].frequency = rest ? 0 : OCTAVE_8[semitone] >> (MAX_OCTAVE - octave);
+        notes[count].duration = ms;
+        count++;
+
+        skipSpaces(c);
+        if (*c == ',') c++;
+        else if (*c != '\0') return 0;
+    }
+
+    return count;
+}
+
+}  // namespace Rtttl
@@ -0,0 +1,24 @@
+#ifndef RTTTL_H
+#define RTTTL_H
+
+#include <Arduino.h>
+#include "melody_sequencer.h"
+
+// Melodias no formato RTTTL (Ring Tone Text Transfer Language), usado pelo
+// PLAY:
+//
+//   nome:d=4,o=5,b=120:8c,8d,e,p,16g#6.
+//
+// Seções: nome, padrões (d = duração, o = oitava, b = batidas por minuto) e
+// notas separadas por vírgula: [duração]nota[#][.][oitava][.], com a nota de
+// a a g ou p (pausa). A duração é a fração da semibreve (1, 2, 4, 8, 16, 32)
+// e o ponto a aumenta pela metade.
+namespace Rtttl {
+
+// Converte o texto em notas. Retorna o número de notas, ou 0 se o texto for
+// inválido ou tiver mais de capacity notas.
+size_t parse(const char* text, MelodyNote* notes, size_t capacity);
+
+}  // namespace Rtttl
+
+#endif
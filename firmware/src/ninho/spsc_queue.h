@@ -0,0 +1,50 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+// Fila circular sem trava para exatamente UM produtor e UM consumidor,
+// que podem estar em núcleos (ou tarefas) diferentes.
+// O produtor só escreve "head" e o consumidor só escreve "tail"; as
+// barreiras acquire/release garantem que o item é visto completo.
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N deve ser potencia de 2");
+
+public:
+    // Chamado apenas pelo produtor. Retorna false se a fila estiver cheia.
+    // Sempre expandido em quem chama: o produtor pode ser uma interrupção em
+    // IRAM, que não pode chamar código da flash.
+    __attribute__((always_inline)) bool push(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Chamado apenas pelo consumidor. Retorna false se a fila estiver vazia.
+    bool pop(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+private:
+    T items[N];
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef TASK_MESSAGES_H
+#define TASK_MESSAGES_H
+
+#include <Arduino.h>
+#include "mission_registry.h"
+
+// Mensagens trocadas entre a tarefa de comunicação (loop) e a tarefa das
+// missões. São estruturas simples, copiadas por valor nas filas SPSC.
+
+// Comunicação → missões
+struct MissionCommand {
+    enum Type : uint8_t {
+        SET_MISSION,
+        SET_CAPTURE,
+        LOAD_PROGRAM,  // Copiar o programa novo do MissionProgramStore
+        SET_PARAM,
+        LOAD_MELODY    // Copiar a melodia recebida pelo PLAY
+    };
+
+    Type type;
+    MissionId mission;  // SET_MISSION, SET_PARAM
+    uint8_t param;      // SET_PARAM: índice do parâmetro na tabela da missão
+    uint32_t value;     // SET_CAPTURE: período de amostragem em ticks (0 = desligada)
+                        // SET_PARAM: novo valor
+                        // LOAD_MELODY: 1 = repetir ao fim
+};
+
+// Entradas lidas uma única vez por tick, no começo do tick, pela tarefa das
+// missões. A missão age sobre esta leitura, e a telemetria, o GET_STATUS e
+// a captura mostram a mesma, sem ler o botão ou o ADC de novo.
+struct InputSnapshot {
+    uint32_t seq;         // Número do tick (1 na primeira leitura)
+    unsigned long time;   // millis() da leitura
+    uint8_t btn;          // Nível já sem repiques (HIGH/LOW)
+    uint8_t presses;      // Apertos desde o tick anterior
+    uint16_t pot;         // 0 a 4095, já filtrado
+    uint16_t potMin;      // Menor, maior e média do potenciômetro na janela
+    uint16_t potMax;      // recente (~100ms, PotSampler::WINDOW)
+    uint16_t potMean;
+};
+
+// Missões → comunicação: estado das entradas/saídas ao fim de um tick
+struct SensorSnapshot {
+    InputSnapshot inputs;
+    MissionId mission;
+    uint8_t led;
+};
+
+// Missões → comunicação: uma amostra da captura em alta taxa
+// "levels" guarda um bit por sinal digital (CAPTURE_*)
+struct CaptureSample {
+    uint32_t time;   // micros() da amostra
+    uint16_t pot;
+    uint8_t levels;
+};
+
+const uint8_t CAPTURE_LED = 1 << 0;
+const uint8_t CAPTURE_LED_2 = 1 << 1;
+const uint8_t CAPTURE_BUZZER = 1 << 2;
+const uint8_t CAPTURE_BUTTON = 1 << 3;  // Nível bruto do pino (mostra o repique)
+
+#endif
@@ -0,0 +1,101 @@
+#include "telemetry_encoder.h"
+#include <ArduinoJson.h>
+
+static const char READINGS[] = ",\"readings\":{\"led\":";
+static const char BTN[] = ",\"btn\":";
+static const char POT[] = ",\"pot\":";
+static const char POT_MIN[] = ",\"potMin\":";
+static const char POT_MAX[] = ",\"potMax\":";
+static const char POT_MEAN[] = ",\"potMean\":";
+static const char TICK[] = "},\"tick\":";
+static const char END[] = "}";
+static const char READINGS_END[] = "}}";
+
+// Números escritos depois do esqueleto (além do "led")
+static const size_t FIELDS = 6;
+
+// Maior texto de um int (sinal e 10 dígitos)
+static const size_t INT_DIGITS = 11;
+
+static size_t writeUint(char* out, uint32_t value) {
+    char digits[INT_DIGITS];
+    size_t count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    size_t length = 0;
+    while (count > 0) out[length++] = digits[--count];
+    return length;
+}
+
+// Mesmo formato do ArduinoJson para inteiros: decimal, '-' se negativo
+static size_t writeInt(char* out, int value) {
+    if (value >= 0) return writeUint(out, (uint32_t)value);
+    out[0] = '-';
+    return 1 + writeUint(out + 1, 0u - (uint32_t)value);
+}
+
+void TelemetryEncoder::prepare(const char* userId, uint32_t userGeneration, const char* missionId) {
+    if (prepared && missionId == this->missionId && userGeneration == this->userGeneration) {
+        return;
+    }
+
+    this->missionId = missionId;
+    this->userGeneration = userGeneration;
+    prepared = true;
+    skeletonLength = 0;
+
+    StaticJsonDocument<JSON_OBJECT_SIZE(3)> doc;
+    doc["type"] = "TELEMETRY";
+    doc["userId"] = userId;
+    doc["missionId"] = missionId;
+
+    // {"type":...,"missionId":"..."} sem a '}' final, seguido de "readings":{"led":
+    size_t length = serializeJson(doc, skeleton, sizeof(skeleton));
+    if (length < 2 || length + sizeof(READINGS) > sizeof(skeleton)) {
+        return;
+    }
+    length--;
+    memcpy(skeleton + length, READINGS, sizeof(READINGS) - 1);
+    skeletonLength = length + sizeof(READINGS) - 1;
+}
+
+// Copia um texto fixo (sem o terminador)
+template <size_t N>
+static size_t writeText(char* out, const char (&text)[N]) {
+    memcpy(out, text, N - 1);
+    return N - 1;
+}
+
+size_t TelemetryEncoder::encode(char* out, size_t capacity, int led, const InputSnapshot& inputs,
+                                bool extended) const {
+    size_t longest = skeletonLength + (FIELDS + 1) * INT_DIGITS + sizeof(BTN) + sizeof(POT) + sizeof(POT_MIN)
+                   + sizeof(POT_MAX) + sizeof(POT_MEAN) + sizeof(TICK) + sizeof(END);
+    if (skeletonLength == 0 || longest > capacity) {
+        return 0;
+    }
+
+    size_t length = skeletonLength;
+    memcpy(out, skeleton, length);
+    length += writeInt(out + length, led);
+    length += writeText(out + length, BTN);
+    length += writeInt(out + length, inputs.btn);
+    length += writeText(out + length, POT);
+    length += writeInt(out + length, inputs.pot);
+    if (!extended) {
+        length += writeText(out + length, READINGS_END);
+        return length;
+    }
+    length += writeText(out + length, POT_MIN);
+    length += writeInt(out + length, inputs.potMin);
+    length += writeText(out + length, POT_MAX);
+    length += writeInt(out + length, inputs.potMax);
+    length += writeText(out + length, POT_MEAN);
+    length += writeInt(out + length, inputs.potMean);
+    length += writeText(out + length, TICK);
+    length += writeUint(out + length, inputs.seq);
+    length += writeText(out + length, END);
+    return length;
+}
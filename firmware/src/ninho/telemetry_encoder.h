@@ -0,0 +1,43 @@
+#ifndef TELEMETRY_ENCODER_H
+#define TELEMETRY_ENCODER_H
+
+#include <Arduino.h>
+#include "task_messages.h"
+
+// Monta o JSON da telemetria sem passar pelo ArduinoJson a cada envio.
+// O esquema é fixo:
+//
+//   {"type":"TELEMETRY","userId":"...","missionId":"...",
+//    "readings":{"led":1,"btn":0,"pot":2048}}
+//
+// ou, com extended (SET_TELEMETRY "extended": true):
+//
+//   {"type":"TELEMETRY","userId":"...","missionId":"...",
+//    "readings":{"led":1,"btn":0,"pot":2048,"potMin":2040,"potMax":2056,"potMean":2047},"tick":1234}
+//
+// Tudo até "led": (o esqueleto) é serializado pelo ArduinoJson uma única vez,
+// quando o userId ou a missão mudam, então os textos saem com o mesmo escape
+// de antes. A cada envio só os números são escritos depois dele, e o
+// resultado é idêntico, byte a byte, ao do serializeJson.
+class TelemetryEncoder {
+public:
+    // Refaz o esqueleto se algo mudou. A missão é comparada pelo endereço
+    // (os nomes vêm da tabela fixa MissionRegistry::NAMES) e o userId pela
+    // geração do UserIdStore, sem comparar strings.
+    void prepare(const char* userId, uint32_t userGeneration, const char* missionId);
+
+    // Escreve o JSON (sem terminador) e retorna o tamanho, ou 0 se não couber
+    // ou se o esqueleto não pôde ser montado
+    size_t encode(char* out, size_t capacity, int led, const InputSnapshot& inputs, bool extended) const;
+
+private:
+    // Cabe o userId com todos os caracteres escapados e o nome de missão mais longo
+    char skeleton[256];
+    size_t skeletonLength = 0;
+
+    const char* missionId = nullptr;
+    uint32_t userGeneration = 0;
+    bool prepared = false;
+};
+
+#endif
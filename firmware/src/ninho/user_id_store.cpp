@@ -2,16 +2,30 @@
 
 void UserIdStore::begin() {
     preferences.begin("ninho", false);
-}
 
-void UserIdStore::setUserId(const String& id) {
-    preferences.putString("userId", id);
+    stored = preferences.isKey("userId");
+    if (stored && preferences.getString("userId", userId, sizeof(userId)) == 0) {
+        // Valor salvo inválido ou maior que o buffer: trata como ausente
+        userId[0] = '\0';
+        stored = false;
+    }
+    changes++;
 }
 
-String UserIdStore::getUserId() {
-    return preferences.getString("userId", "");
-}
+bool UserIdStore::setUserId(const char* id) {
+    size_t length = strlen(id);
+    if (length > MAX_LENGTH) {
+        return false;
+    }
+
+    // Mesmo valor: evita desgastar a flash e invalidar caches
+    if (stored && strcmp(userId, id) == 0) {
+        return true;
+    }
 
-bool UserIdStore::hasUserId() {
-    return preferences.isKey("userId");
+    memcpy(userId, id, length + 1);
+    preferences.putString("userId", userId);
+    stored = true;
+    changes++;
+    return true;
 }
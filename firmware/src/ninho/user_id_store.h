@@ -4,15 +4,29 @@
 #include <Arduino.h>
 #include <Preferences.h>
 
+// Guarda o userId na NVS e mantém uma cópia em RAM.
+// A flash só é lida no begin() e só é escrita quando o valor muda.
 class UserIdStore {
 public:
+    // Tamanho máximo do userId (sem o '\0')
+    static const size_t MAX_LENGTH = 64;
+
     void begin();
-    void setUserId(const String& id);
-    String getUserId();
-    bool hasUserId();
+
+    // Retorna false se o id for longo demais (nada é alterado)
+    bool setUserId(const char* id);
+    const char* getUserId() const { return userId; }
+    bool hasUserId() const { return stored; }
+
+    // Incrementa a cada troca de id: quem guarda o último valor visto
+    // sabe, sem comparar strings, se precisa refazer algum trabalho
+    uint32_t generation() const { return changes; }
 
 private:
     Preferences preferences;
+    char userId[MAX_LENGTH + 1] = "";
+    bool stored = false;
+    uint32_t changes = 0;
 };
 
 #endif
@@ -0,0 +1,96 @@
+/**
+ * Waveform View - Desenha as formas de onda da captura em alta taxa
+ * Recebe os quadros SAMPLES do firmware (comando SET_CAPTURE)
+ */
+
+import React from 'react';
+
+// Bits do campo "io" de cada amostra (firmware/src/ninho/task_messages.h)
+const CAPTURE_LED = 1 << 0;
+const CAPTURE_LED_2 = 1 << 1;
+const CAPTURE_BUZZER = 1 << 2;
+const CAPTURE_BUTTON = 1 << 3;
+
+export interface WaveformSample {
+  time: number; // micros() do ESP32
+  io: number;
+  pot: number;
+}
+
+export interface SamplesFrame {
+  type: 'SAMPLES';
+  t0: number;
+  t: number[];
+  io: number[];
+  pot: number[];
+}
+
+// Converte um quadro SAMPLES em amostras com instante absoluto
+export const unpackSamples = (frame: SamplesFrame): WaveformSample[] =>
+  frame.t.map((offset, i) => ({
+    time: (frame.t0 + offset) >>> 0,
+    io: frame.io[i],
+    pot: frame.pot[i],
+  }));
+
+export interface WaveformViewProps {
+  samples: WaveformSample[];
+  width?: number;
+}
+
+const TRACES = [
+  { label: 'LED', bit: CAPTURE_LED, color: '#ef4444' },
+  { label: 'LED2', bit: CAPTURE_LED_2, color: '#f97316' },
+  { label: 'BUZ', bit: CAPTURE_BUZZER, color: '#a855f7' },
+  { label: 'BTN', bit: CAPTURE_BUTTON, color: '#3b82f6' },
+];
+
+const TRACE_HEIGHT = 20;
+const POT_HEIGHT = 60;
+const LABEL_WIDTH = 40;
+
+export const WaveformView: React.FC<WaveformViewProps> = ({ samples, width = 480 }) => {
+  if (samples.length < 2) {
+    return <div className="text-xs text-gray-400">Aguardando amostras...</div>;
+  }
+
+  // micros() dá a volta a cada ~71 minutos: os instantes são relativos à primeira amostra
+  const start = samples[0].time;
+  const span = ((samples[samples.length - 1].time - start) >>> 0) || 1;
+  const plotWidth = width - LABEL_WIDTH;
+  const x = (time: number) => LABEL_WIDTH + (((time - start) >>> 0) / span) * plotWidth;
+
+  // Degraus: cada nível vale até a amostra seguinte
+  const digitalPath = (bit: number, top: number) => {
+    const y = (s: WaveformSample) => (s.io & bit ? top + 2 : top + TRACE_HEIGHT - 2);
+    let path = `M ${x(samples[0].time)} ${y(samples[0])}`;
+    for (let i = 1; i < samples.length; i++) {
+      path += ` H ${x(samples[i].time)} V ${y(samples[i])}`;
+    }
+    return path;
+  };
+
+  const potTop = TRACES.length * TRACE_HEIGHT;
+  const potPath = samples
+    .map((s, i) => `${i === 0 ? 'M' : 'L'} ${x(s.time)} ${potTop + POT_HEIGHT - (s.pot / 4095) * POT_HEIGHT}`)
+    .join(' ');
+
+  const height = potTop + POT_HEIGHT;
+
+  return (
+    <svg width={width} height={height} className="bg-gray-900 rounded-xl">
+      {TRACES.map((trace, i) => (
+        <g key={trace.label}>
+          <text x={4} y={i * TRACE_HEIGHT + 14} fontSize={10} fill="#9ca3af">
+            {trace.label}
+          </text>
+          <path d={digitalPath(trace.bit, i * TRACE_HEIGHT)} stroke={trace.color} fill="none" strokeWidth={1.5} />
+        </g>
+      ))}
+      <text x={4} y={potTop + 14} fontSize={10} fill="#9ca3af">
+        POT
+      </text>
+      <path d={potPath} stroke="#22c55e" fill="none" strokeWidth={1.5} />
+    </svg>
+  );
+};
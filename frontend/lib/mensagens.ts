@@ -0,0 +1,199 @@
+/**
+ * Mensagens em MessagePack - o formato binário do firmware
+ * (SET_FORMAT "msgpack", firmware/src/ninho/protocol.h):
+ *
+ *   - comandos e respostas são mapas com os mesmos campos do JSON
+ *   - os quadros automáticos (TELEMETRY sem "seq" e SAMPLES) são arrays
+ *     posicionais, sem os nomes dos campos; o primeiro elemento diz qual
+ *     quadro é (Protocol::CompactFrame)
+ *
+ * Só o subconjunto que o ArduinoJson escreve e lê: nil, booleanos, inteiros,
+ * float, textos, arrays e mapas.
+ */
+
+import type { TelemetriaESP } from "../types";
+
+// Identificador de cada quadro compacto, na mesma ordem de Protocol::CompactFrame
+export const QUADRO_TELEMETRIA = 1;
+export const QUADRO_AMOSTRAS = 2;
+
+// Nomes das missões, na mesma ordem do enum MissionId (mission_registry.h):
+// a telemetria compacta manda o índice
+export const MISSOES = [
+  "IDLE",
+  "INTRO",
+  "MISSION_1_ON",
+  "MISSION_1_BLINK",
+  "MISSION_2_LED_1K",
+  "MISSION_2_DOORBELL",
+  "MISSION_2_TOGGLE",
+  "MISSION_3_BUZZER",
+  "MISSION_3_READ",
+  "MISSION_3_PWM",
+  "MISSION_4_STATE_MACHINE",
+  "MISSION_5_FINAL",
+  "CUSTOM",
+];
+
+const codificador = new TextEncoder();
+const decodificador = new TextDecoder();
+
+/**
+ * Codifica um comando (objeto com textos, números e booleanos)
+ */
+export const codificarMsgpack = (valor: any): Uint8Array => {
+  const bytes: number[] = [];
+  // Tipo seguido de um tamanho ou número big-endian de 1, 2 ou 4 bytes
+  const cabecalho = (tipo: number, numero: number, tamanho: number) => {
+    bytes.push(tipo);
+    for (let deslocamento = (tamanho - 1) * 8; deslocamento >= 0; deslocamento -= 8) {
+      bytes.push((numero >>> deslocamento) & 0xff);
+    }
+  };
+
+  const escrever = (v: any) => {
+    if (v === null || v === undefined) {
+      bytes.push(0xc0);
+    } else if (typeof v === "boolean") {
+      bytes.push(v ? 0xc3 : 0xc2);
+    } else if (typeof v === "number" && Number.isInteger(v) && v >= -0x80000000 && v <= 0xffffffff) {
+      if (v >= 0 && v < 0x80) bytes.push(v);
+      else if (v < 0 && v >= -32) bytes.push(v & 0xff);
+      else if (v >= 0 && v <= 0xff) cabecalho(0xcc, v, 1);
+      else if (v >= 0 && v <= 0xffff) cabecalho(0xcd, v, 2);
+      else if (v >= 0) cabecalho(0xce, v, 4);
+      else cabecalho(0xd2, v, 4);
+    } else if (typeof v === "number") {
+      const dados = new DataView(new ArrayBuffer(8));
+      dados.setFloat64(0, v);
+      bytes.push(0xcb, ...new Uint8Array(dados.buffer));
+    } else if (typeof v === "string") {
+      const texto = codificador.encode(v);
+      if (texto.length < 32) bytes.push(0xa0 | texto.length);
+      else if (texto.length <= 0xff) cabecalho(0xd9, texto.length, 1);
+      else cabecalho(0xda, texto.length, 2);
+      bytes.push(...texto);
+    } else if (Array.isArray(v)) {
+      if (v.length < 16) bytes.push(0x90 | v.length);
+      else cabecalho(0xdc, v.length, 2);
+      v.forEach(escrever);
+    } else {
+      const campos = Object.entries(v).filter(([, item]) => item !== undefined);
+      if (campos.length < 16) bytes.push(0x80 | campos.length);
+      else cabecalho(0xde, campos.length, 2);
+      for (const [chave, item] of campos) {
+        escrever(chave);
+        escrever(item);
+      }
+    }
+  };
+
+  escrever(valor);
+  return new Uint8Array(bytes);
+};
+
+/**
+ * Decodifica uma mensagem. Lança erro se os bytes não formarem um valor
+ * completo.
+ */
+export const decodificarMsgpack = (dados: Uint8Array): any => {
+  const visao = new DataView(dados.buffer, dados.byteOffset, dados.byteLength);
+  let posicao = 0;
+
+  const avancar = (bytes: number) => {
+    const inicio = posicao;
+    posicao += bytes;
+    if (posicao > dados.length) throw new Error("MessagePack incompleto");
+    return inicio;
+  };
+  const texto = (tamanho: number) => {
+    const inicio = avancar(tamanho);
+    return decodificador.decode(dados.subarray(inicio, inicio + tamanho));
+  };
+  const array = (tamanho: number) => {
+    const valor: any[] = [];
+    for (let i = 0; i < tamanho; i++) valor.push(ler());
+    return valor;
+  };
+  const mapa = (tamanho: number) => {
+    const valor: Record<string, any> = {};
+    for (let i = 0; i < tamanho; i++) {
+      const chave = ler();
+      valor[chave] = ler();
+    }
+    return valor;
+  };
+
+  // Tamanhos e números de tamanho fixo: quantos bytes e como ler
+  const leitores: Record<number, [number, (inicio: number) => any]> = {
+    0xcc: [1, (i) => visao.getUint8(i)],
+    0xcd: [2, (i) => visao.getUint16(i)],
+    0xce: [4, (i) => visao.getUint32(i)],
+    0xcf: [8, (i) => Number(visao.getBigUint64(i))],
+    0xd0: [1, (i) => visao.getInt8(i)],
+    0xd1: [2, (i) => visao.getInt16(i)],
+    0xd2: [4, (i) => visao.getInt32(i)],
+    0xd3: [8, (i) => Number(visao.getBigInt64(i))],
+    0xca: [4, (i) => visao.getFloat32(i)],
+    0xcb: [8, (i) => visao.getFloat64(i)],
+    0xd9: [1, (i) => texto(visao.getUint8(i))],
+    0xda: [2, (i) => texto(visao.getUint16(i))],
+    0xdb: [4, (i) => texto(visao.getUint32(i))],
+    0xdc: [2, (i) => array(visao.getUint16(i))],
+    0xdd: [4, (i) => array(visao.getUint32(i))],
+    0xde: [2, (i) => mapa(visao.getUint16(i))],
+    0xdf: [4, (i) => mapa(visao.getUint32(i))],
+  };
+
+  const ler = (): any => {
+    const tipo = dados[avancar(1)];
+    if (tipo <= 0x7f) return tipo;
+    if (tipo >= 0xe0) return tipo - 0x100;
+    if (tipo >= 0xa0 && tipo <= 0xbf) return texto(tipo & 0x1f);
+    if (tipo >= 0x90 && tipo <= 0x9f) return array(tipo & 0x0f);
+    if (tipo >= 0x80 && tipo <= 0x8f) return mapa(tipo & 0x0f);
+    if (tipo === 0xc0) return null;
+    if (tipo === 0xc2) return false;
+    if (tipo === 0xc3) return true;
+    const leitor = leitores[tipo];
+    if (leitor) return leitor[1](avancar(leitor[0]));
+    throw new Error(`Tipo MessagePack 0x${tipo.toString(16)} não suportado`);
+  };
+
+  return ler();
+};
+
+/**
+ * Devolve um quadro compacto com os campos nomeados, igual ao do JSON (a
+ * telemetria compacta não traz o userId; potMin, potMax, potMean e tick só
+ * vêm com SET_TELEMETRY "extended"). Mapas passam como estão.
+ */
+export const expandirQuadro = (mensagem: any): any => {
+  if (!Array.isArray(mensagem)) return mensagem;
+
+  const [quadro, ...campos] = mensagem;
+  if (quadro === QUADRO_TELEMETRIA) {
+    const [missao, led, btn, pot, ...estendidos] = campos;
+    const telemetria: TelemetriaESP = {
+      type: "TELEMETRY",
+      missionId: MISSOES[missao] ?? String(missao),
+      readings: { led, btn, pot },
+    };
+    if (estendidos.length > 0) {
+      const [potMin, potMax, potMean, tick] = estendidos;
+      telemetria.readings = { ...telemetria.readings, potMin, potMax, potMean };
+      telemetria.tick = tick;
+    }
+    return telemetria;
+  }
+  if (quadro === QUADRO_AMOSTRAS) {
+    const [t0, t, io, pot] = campos;
+    return { type: "SAMPLES", t0, t, io, pot };
+  }
+  return { type: "UNKNOWN", campos };
+};
+
+/**
+ * Lê uma mensagem do firmware em MessagePack, já com os campos nomeados
+ */
+export const lerMensagem = (dados: Uint8Array): any => expandirQuadro(decodificarMsgpack(dados));
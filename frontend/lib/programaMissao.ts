@@ -0,0 +1,53 @@
+/**
+ * Programa Missão - Monta o bytecode da missão CUSTOM do firmware
+ * (formato em firmware/src/ninho/mission_program.h), enviado com LOAD_MISSION
+ */
+
+const VERSAO = 1;
+
+// Instruções, na mesma ordem do enum MissionProgram::Op
+export const Op = {
+  END: 0, //                          Termina o tick
+  SET_OUT: 1, // saída, nível
+  TOGGLE_OUT: 2, // saída
+  MIRROR_BUTTON: 3, // saída          Saída acompanha o botão
+  PWM_POT: 4, // saída                Brilho proporcional ao potenciômetro
+  TONE: 5, // hz16, ms16
+  NO_TONE: 6,
+  NEXT_NOTE: 7, // ms16               Próxima nota da tabela (em ciclo)
+  EVERY: 8, // timer, ms16            Temporizador não venceu: termina o tick
+  IF_PRESSED: 9, // salto             Sem aperto neste tick: pula "salto" bytes
+  IF_BUTTON: 10, // nível, salto
+  GOTO: 11, // estado                 Troca de estado e termina o tick
+  BLINK: 12, // saída, ms16           Pisca a saída (esp_timer, sem trabalho no tick)
+  FADE: 13, // saída, duty, ms16      Leva o brilho (0 a 255) ao valor em ms16
+} as const;
+
+// Saídas endereçáveis pelo programa
+export const LED = 0;
+export const LED_2 = 1;
+
+// Número de 16 bits como dois operandos (big-endian)
+export const u16 = (valor: number): number[] => [(valor >> 8) & 0xff, valor & 0xff];
+
+/**
+ * Junta o código de cada estado (instruções e operandos) e a tabela de
+ * notas num programa. A validação completa é feita pela placa.
+ */
+export const montarPrograma = (estados: number[][], notas: number[] = []): Uint8Array => {
+  const inicios: number[] = [];
+  let posicao = 0;
+  for (const estado of estados) {
+    inicios.push(posicao);
+    posicao += estado.length;
+  }
+
+  return new Uint8Array([
+    VERSAO,
+    estados.length,
+    notas.length,
+    ...notas.flatMap(u16),
+    ...inicios.flatMap(u16),
+    ...estados.flat(),
+  ]);
+};
@@ -0,0 +1,92 @@
+/**
+ * Quadros COBS com CRC-16 - o mesmo enquadramento do firmware
+ * (firmware/src/ninho/frame_codec.h):
+ *
+ *   COBS(conteúdo + CRC-16 big-endian) + 0x00
+ *
+ * O 0x00 só aparece como delimitador, então um quadro corrompido é
+ * descartado inteiro e a leitura continua no próximo 0x00.
+ */
+
+// CRC-16/CCITT-FALSE: polinômio 0x1021, valor inicial 0xFFFF
+const TABELA_CRC = (() => {
+  const tabela = new Uint16Array(256);
+  for (let i = 0; i < 256; i++) {
+    let crc = i << 8;
+    for (let bit = 0; bit < 8; bit++) {
+      crc = crc & 0x8000 ? ((crc << 1) ^ 0x1021) & 0xffff : (crc << 1) & 0xffff;
+    }
+    tabela[i] = crc;
+  }
+  return tabela;
+})();
+
+export const crc16 = (dados: Uint8Array): number => {
+  let crc = 0xffff;
+  for (const byte of dados) {
+    crc = ((crc << 8) & 0xffff) ^ TABELA_CRC[(crc >> 8) ^ byte];
+  }
+  return crc;
+};
+
+/**
+ * Monta um quadro pronto para a Serial, com o 0x00 final
+ */
+export const montarQuadro = (conteudo: Uint8Array): Uint8Array => {
+  const crc = crc16(conteudo);
+  const entrada = new Uint8Array(conteudo.length + 2);
+  entrada.set(conteudo);
+  entrada[conteudo.length] = crc >> 8;
+  entrada[conteudo.length + 1] = crc & 0xff;
+
+  // Pior caso: um byte a mais a cada 254, mais o código inicial e o 0x00
+  const saida = new Uint8Array(entrada.length + Math.floor(entrada.length / 254) + 2);
+  let posicaoCodigo = 0;
+  let escritos = 1;
+  let codigo = 1;
+
+  for (const byte of entrada) {
+    if (byte === 0) {
+      saida[posicaoCodigo] = codigo;
+      posicaoCodigo = escritos++;
+      codigo = 1;
+      continue;
+    }
+    saida[escritos++] = byte;
+    if (++codigo === 0xff) {
+      saida[posicaoCodigo] = codigo;
+      posicaoCodigo = escritos++;
+      codigo = 1;
+    }
+  }
+
+  saida[posicaoCodigo] = codigo;
+  saida[escritos++] = 0;
+  return saida.subarray(0, escritos);
+};
+
+/**
+ * Decodifica um quadro (sem o 0x00 final) e confere o CRC.
+ * Retorna o conteúdo, ou null se o quadro estiver corrompido.
+ */
+export const abrirQuadro = (quadro: Uint8Array): Uint8Array | null => {
+  const saida = new Uint8Array(quadro.length);
+  let lidos = 0;
+  let escritos = 0;
+
+  while (lidos < quadro.length) {
+    const codigo = quadro[lidos++];
+    if (codigo === 0 || lidos + codigo - 1 > quadro.length) return null;
+    for (let i = 1; i < codigo; i++) {
+      saida[escritos++] = quadro[lidos++];
+    }
+    if (codigo !== 0xff && lidos < quadro.length) {
+      saida[escritos++] = 0;
+    }
+  }
+
+  if (escritos < 2) return null;
+  const conteudo = saida.subarray(0, escritos - 2);
+  const recebido = (saida[escritos - 2] << 8) | saida[escritos - 1];
+  return crc16(conteudo) === recebido ? conteudo : null;
+};
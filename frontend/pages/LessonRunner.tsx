@@ -1,8 +1,12 @@
 import React, { useState, useEffect } from "react";
-import { Lesson } from "../types";
+import { Lesson, EspTelemetry } from "../types";
 import { Button } from "../components/ui/Button";
 import { espService } from "../services/espService";
 import { missions, Mission } from "../data/missions";
+import { WaveformView, WaveformSample, unpackSamples } from "../components/esp/WaveformView";
+
+// Amostras mantidas na forma de onda (1s a 500 Hz)
+const MAX_WAVEFORM_SAMPLES = 500;
 
 interface LessonRunnerProps {
   lesson: Lesson;
@@ -20,7 +24,9 @@ export const LessonRunner: React.FC<LessonRunnerProps> = ({ lesson, user, onComp
   const [selectedOption, setSelectedOption] = useState<number | null>(null);
   const [quizStatus, setQuizStatus] = useState<"idle" | "correct" | "wrong">("idle");
   const [isConnected, setIsConnected] = useState(false);
-  const [telemetry, setTelemetry] = useState<any>(null);
+  const [telemetry, setTelemetry] = useState<EspTelemetry | null>(null);
+  const [waveform, setWaveform] = useState<WaveformSample[]>([]);
+  const [capturing, setCapturing] = useState(false);
   const [practiceStatus, setPracticeStatus] = useState<"idle" | "running" | "success">("idle");
 
   useEffect(() => {
@@ -52,7 +58,12 @@ export const LessonRunner: React.FC<LessonRunnerProps> = ({ lesson, user, onComp
       };
 
       espService.onTelemetry = (data) => {
-        setTelemetry(data);
+        if (data.type === "SAMPLES") {
+          const samples = unpackSamples(data);
+          setWaveform((prev) => [...prev, ...samples].slice(-MAX_WAVEFORM_SAMPLES));
+        } else if (data.type === "TELEMETRY") {
+          setTelemetry(data);
+        }
       };
     }
     return () => {
@@ -91,15 +102,27 @@ export const LessonRunner: React.FC<LessonRunnerProps> = ({ lesson, user, onComp
 
   const handleStartPractice = async () => {
     if (!isConnected) return;
-    await espService.enviarComando("SET_MISSION", { missionId: mission.practice.firmwareCommand });
+    const resposta = await espService.executar("SET_MISSION", { missionId: mission.practice.firmwareCommand });
+    if (resposta?.type === "ERROR") {
+      console.error("[LessonRunner] ESP32 recusou a missão:", resposta.message);
+      return;
+    }
     setPracticeStatus("running");
   };
 
+  const handleToggleCapture = async () => {
+    if (!isConnected) return;
+    await espService.enviarComando("SET_CAPTURE", { rateHz: capturing ? 0 : 500, batch: 32 });
+    if (!capturing) setWaveform([]);
+    setCapturing(!capturing);
+  };
+
   const handleFinish = async (xp?: number) => {
     // Se estiver conectado e rodando prática, para a missão no firmware
     if (isConnected && practiceStatus === "running") {
       try {
         await espService.enviarComando("SET_MISSION", { missionId: "IDLE" });
+        if (capturing) await espService.enviarComando("SET_CAPTURE", { rateHz: 0 });
       } catch (e) {
         console.error("Erro ao parar missão:", e);
       }
@@ -112,6 +135,7 @@ export const LessonRunner: React.FC<LessonRunnerProps> = ({ lesson, user, onComp
     if (isConnected && practiceStatus === "running") {
       try {
         await espService.enviarComando("SET_MISSION", { missionId: "IDLE" });
+        if (capturing) await espService.enviarComando("SET_CAPTURE", { rateHz: 0 });
       } catch (e) {
         console.error("Erro ao parar missão:", e);
       }
@@ -273,6 +297,10 @@ export const LessonRunner: React.FC<LessonRunnerProps> = ({ lesson, user, onComp
                   </>
                 )}
               </div>
+              <Button fullWidth variant="secondary" onClick={handleToggleCapture}>
+                {capturing ? "⏹ Parar forma de onda" : "📈 Ver forma de onda"}
+              </Button>
+              {capturing && <WaveformView samples={waveform} />}
               <p className="text-sm font-bold text-brand-brown">Observe seu ESP32! O comportamento deve estar conforme a teoria.</p>
               <Button fullWidth variant="success" onClick={() => handleFinish()}>
                 Funcionou! Concluir Missão
@@ -6,21 +6,81 @@
 import { connectESP, formatMacAddr } from "../lib/esptool";
 import type { EspTelemetry, ConnectionStatus } from "../types";
 import { missions } from "../data/missions";
+import { abrirQuadro, montarQuadro } from "../lib/quadros";
+import { codificarMsgpack, lerMensagem } from "../lib/mensagens";
+
+// Velocidade da Serial: a placa sempre liga em 115200 e o SET_BAUD negocia
+// uma maior. As candidatas são tentadas em ordem; se o PING não voltar na
+// nova velocidade, as duas pontas voltam para 115200.
+const BAUD_PADRAO = 115200;
+const BAUDS_CANDIDATOS = [2000000, 921600];
+const TIMEOUT_ACK_BAUD = 500; // Firmware antigo ignora o SET_BAUD
+const TIMEOUT_PONG = 700;
+const INTERVALO_PING = 100;
+// A placa desiste da nova velocidade 1s depois do ACK; esperamos um pouco mais
+// antes de reabrir em 115200 para não falar com ela na velocidade errada
+const ESPERA_VOLTA_PLACA = 1200;
+// Fora de 115200 a placa volta sozinha depois de 5s sem comandos: o PING
+// periódico mantém a velocidade enquanto a porta estiver aberta
+const INTERVALO_KEEPALIVE = 2000;
+// Ao recarregar a página a placa continua na velocidade e no enquadramento
+// negociados: procuramos por ela com um PING em cada combinação
+const TIMEOUT_SONDA = 200;
+// Sem resposta em nenhuma, esperamos a placa voltar sozinha para 115200 e
+// linhas de JSON (5s sem comandos válidos) antes de desistir
+const ESPERA_LINK_PADRAO = 5500;
+
+// Tempo máximo pela resposta de um comando enviado com executar()
+const TIMEOUT_RESPOSTA = 1000;
+// Reenvios de um comando pedidos por NAK (quadro corrompido na placa)
+const MAX_REENVIOS = 3;
+// Bytes de programa por LOAD_MISSION: em base64 o comando cabe nas 256 bytes
+// da linha do firmware
+const PEDACO_PROGRAMA = 96;
+// Maior quadro aceito antes do delimitador; o resto é descartado
+const MAX_QUADRO = 4096;
+
+// "linhas": JSON terminado em "\n"; "cobs": quadros COBS com CRC-16 (lib/quadros.ts)
+type Enquadramento = "linhas" | "cobs";
+// Conteúdo de cada quadro COBS: texto JSON ou MessagePack (lib/mensagens.ts),
+// em que a telemetria e as amostras vão como arrays compactos
+type Formato = "json" | "msgpack";
+
+type FiltroMensagem = (data: any) => boolean;
+
+const esperar = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+const codificador = new TextEncoder();
+const decodificador = new TextDecoder();
 
 class ESPService {
   private port: any = null;
-  private reader: ReadableStreamDefaultReader | null = null;
-  private writer: WritableStreamDefaultWriter | null = null;
+  private reader: ReadableStreamDefaultReader<Uint8Array> | null = null;
+  private writer: WritableStreamDefaultWriter<Uint8Array> | null = null;
 
-  // Promises para rastrear fechamento dos streams
-  private readableStreamClosed: Promise<void> | null = null;
-  private writableStreamClosed: Promise<void> | null = null;
-
-  // AbortController para cancelar streams
-  private abortController: AbortController | null = null;
+  // Leitura em andamento, para esperar o fim ao fechar os streams
+  private leitura: Promise<void> | null = null;
 
   private _status: ConnectionStatus = "disconnected";
 
+  private baudAtual = BAUD_PADRAO;
+  private keepalive: ReturnType<typeof setInterval> | null = null;
+
+  private enquadramento: Enquadramento = "linhas";
+  private formato: Formato = "json";
+  // SET_FORMAT com "framing" e "format" enviado: troca ao chegar o ACK
+  private ativandoCobs = false;
+
+  // Próximo "seq" usado por executar()
+  private proximoSeq = 1;
+
+  // Comandos de executar() sem resposta, do mais antigo ao mais novo: um NAK
+  // da placa reenvia todos (ela reconhece os já atendidos pelo "seq")
+  private pendentes: { comando: any; reenvios: number }[] = [];
+
+  // Respostas aguardadas por aguardarMensagem()
+  private aguardando: { filtro: FiltroMensagem; resolver: (data: any) => void }[] = [];
+
   // Callbacks para eventos
   public onStatusChange?: (status: ConnectionStatus) => void;
   public onTelemetry?: (data: any) => void;
@@ -47,27 +107,19 @@ class ESPService {
 
       // Se a porta não estiver aberta, abre
       if (!this.port.readable) {
-        await this.port.open({ baudRate: 115200 });
+        await this.port.open({ baudRate: BAUD_PADRAO });
       }
+      this.baudAtual = BAUD_PADRAO;
 
       this.setStatus("connected");
-      this.abortController = new AbortController();
-
-      // Configura reader/writer para comunicação
-      const decoder = new TextDecoderStream();
-      this.readableStreamClosed = this.port.readable.pipeTo(decoder.writable, { signal: this.abortController.signal });
-      this.reader = decoder.readable.getReader();
-
-      const encoder = new TextEncoderStream();
-      this.writableStreamClosed = encoder.readable.pipeTo(this.port.writable, { signal: this.abortController.signal });
-      this.writer = encoder.writable.getWriter();
-
-      // Inicia leitura em background
-      this.lerSerial();
+      this.abrirStreams();
     } catch (erro) {
       this.setStatus("error");
       throw new Error(`Falha ao conectar com porta existente: ${erro}`);
     }
+
+    await this.negociarVelocidade();
+    await this.ativarEnquadramento();
   }
 
   /**
@@ -88,7 +140,7 @@ class ESPService {
         this.setStatus("connected");
         // Garante que o loop de leitura esteja rodando
         if (!this.reader) {
-          this.lerSerial();
+          this.abrirStreams();
         }
         return;
       }
@@ -102,34 +154,217 @@ class ESPService {
       this.port = await (navigator as any).serial.requestPort();
 
       await this.port.open({
-        baudRate: 115200,
+        baudRate: BAUD_PADRAO,
       });
+      this.baudAtual = BAUD_PADRAO;
 
       this.setStatus("connected");
-      this.abortController = new AbortController();
-
-      // Configura reader/writer para comunicação
-      const decoder = new TextDecoderStream();
-      this.readableStreamClosed = this.port.readable.pipeTo(decoder.writable, { signal: this.abortController.signal });
-      this.reader = decoder.readable.getReader();
-
-      const encoder = new TextEncoderStream();
-      this.writableStreamClosed = encoder.readable.pipeTo(this.port.writable, { signal: this.abortController.signal });
-      this.writer = encoder.writable.getWriter();
-
-      // Inicia leitura em background
-      this.lerSerial();
+      this.abrirStreams();
     } catch (erro) {
       this.setStatus("error");
       throw new Error(`Falha ao conectar: ${erro}`);
     }
+
+    await this.negociarVelocidade();
+    await this.ativarEnquadramento();
+  }
+
+  /**
+   * Configura reader/writer (bytes crus: os quadros COBS não são texto) e
+   * inicia a leitura em background
+   */
+  private abrirStreams() {
+    this.enquadramento = "linhas";
+    this.formato = "json";
+    this.ativandoCobs = false;
+    this.reader = this.port.readable.getReader();
+    this.writer = this.port.writable.getWriter();
+    this.leitura = this.lerSerial();
+  }
+
+  /**
+   * Encerra reader/writer e espera a leitura terminar (a porta continua aberta)
+   */
+  private async fecharStreams() {
+    // 1. Cancel Reader
+    if (this.reader) {
+      await this.reader.cancel().catch(() => {});
+      if (this.leitura) {
+        await this.leitura.catch(() => {});
+        this.leitura = null;
+      }
+      this.reader.releaseLock();
+      this.reader = null;
+    }
+
+    // 2. Release Writer
+    if (this.writer) {
+      this.writer.releaseLock();
+      this.writer = null;
+    }
+  }
+
+  /**
+   * Fecha e reabre a porta em outra velocidade (Web Serial não troca o baud
+   * de uma porta aberta)
+   */
+  private async reabrirPorta(baudRate: number) {
+    // A placa mantém o enquadramento e o formato quando troca de velocidade
+    const { enquadramento, formato } = this;
+    await this.fecharStreams();
+    await this.port.close();
+    await this.port.open({ baudRate });
+    this.baudAtual = baudRate;
+    this.abrirStreams();
+    this.enquadramento = enquadramento;
+    this.formato = formato;
+  }
+
+  /**
+   * Envia um comando e espera a primeira mensagem que satisfaça o filtro.
+   * Resolve com null se nada chegar a tempo.
+   */
+  private async aguardarMensagem(filtro: FiltroMensagem, timeoutMs: number, enviar: () => Promise<void>): Promise<any> {
+    let resolver: (data: any) => void = () => {};
+    const resposta = new Promise<any>((resolve) => {
+      resolver = resolve;
+    });
+    const espera = { filtro, resolver };
+    this.aguardando.push(espera);
+
+    const timeout = setTimeout(() => resolver(null), timeoutMs);
+    try {
+      await enviar();
+      return await resposta;
+    } finally {
+      clearTimeout(timeout);
+      this.aguardando = this.aguardando.filter((item) => item !== espera);
+    }
+  }
+
+  /**
+   * Envia bytes prontos e espera uma resposta. Qualquer mensagem que chegue
+   * inteira (PONG, ou o ERROR de firmware antigo sem PING) mostra que a
+   * velocidade e o enquadramento estão certos.
+   */
+  private async sondar(dados: Uint8Array): Promise<boolean> {
+    const resposta = await this.aguardarMensagem(() => true, TIMEOUT_SONDA, async () => {
+      await this.writer?.write(dados);
+    });
+    return resposta !== null;
+  }
+
+  /**
+   * Procura a placa com PING em cada velocidade, primeiro em linhas de JSON e
+   * depois em COBS com MessagePack. Depois de recarregar a página ela pode
+   * estar em qualquer uma das combinações negociadas antes. Deixa a porta na
+   * que respondeu; sem resposta, espera a placa voltar ao link padrão e tenta
+   * de novo em 115200.
+   */
+  private async procurarPlaca(): Promise<boolean> {
+    for (const baud of [BAUD_PADRAO, ...BAUDS_CANDIDATOS]) {
+      this.enquadramento = "linhas";
+      this.formato = "json";
+      if (baud !== this.baudAtual) await this.reabrirPorta(baud);
+
+      // O "\n" encerra o lixo que a placa recebeu numa velocidade errada
+      if (await this.sondar(codificador.encode('\n{"type":"PING"}\n'))) return true;
+
+      // O 0x00 encerra um quadro COBS incompleto
+      this.enquadramento = "cobs";
+      this.formato = "msgpack";
+      const quadro = montarQuadro(codificarMsgpack({ type: "PING" }));
+      const dados = new Uint8Array(quadro.length + 1);
+      dados.set(quadro, 1);
+      if (await this.sondar(dados)) return true;
+    }
+
+    this.enquadramento = "linhas";
+    this.formato = "json";
+    await this.reabrirPorta(BAUD_PADRAO);
+    console.warn("[ESPService] Placa não respondeu ao PING, esperando o link padrão");
+    await esperar(ESPERA_LINK_PADRAO);
+    return this.sondar(codificador.encode('\n{"type":"PING"}\n'));
+  }
+
+  /**
+   * Negocia uma velocidade maior com o SET_BAUD: a placa escolhe a velocidade
+   * e responde no ACK, as duas pontas trocam e um PING/PONG confirma. Se o PING
+   * não voltar, as duas pontas voltam para 115200 e tentamos a próxima candidata.
+   * Antes, procura a placa: se ela ficou numa velocidade negociada antes (página
+   * recarregada), continua nela. Retorna a velocidade final.
+   */
+  async negociarVelocidade(): Promise<number> {
+    await this.procurarPlaca();
+    if (this.baudAtual !== BAUD_PADRAO) {
+      console.log("[ESPService] Placa já estava em", this.baudAtual, "baud");
+      this.iniciarKeepalive();
+      return this.baudAtual;
+    }
+
+    for (const candidato of BAUDS_CANDIDATOS) {
+      try {
+        const ack = await this.aguardarMensagem(
+          (data) => (data.type === "ACK" && data.command === "SET_BAUD") || data.type === "ERROR",
+          TIMEOUT_ACK_BAUD,
+          () => this.enviarMensagem({ type: "SET_BAUD", baud: candidato }),
+        );
+        // Sem resposta: firmware sem SET_BAUD, fica em 115200
+        if (!ack) break;
+        if (ack.type !== "ACK" || !ack.baud) continue;
+        if (ack.baud === this.baudAtual) break;
+
+        await this.reabrirPorta(ack.baud);
+
+        // Repete o PING: o primeiro pode sair antes de a placa trocar
+        const ping = setInterval(() => this.enviarMensagem({ type: "PING" }).catch(() => {}), INTERVALO_PING);
+        let pong: any;
+        try {
+          pong = await this.aguardarMensagem((data) => data.type === "PONG", TIMEOUT_PONG, () =>
+            this.enviarMensagem({ type: "PING" }),
+          );
+        } finally {
+          clearInterval(ping);
+        }
+
+        if (pong) {
+          console.log("[ESPService] Serial em", ack.baud, "baud");
+          this.iniciarKeepalive();
+          return ack.baud;
+        }
+
+        console.warn("[ESPService] Sem PONG em", ack.baud, "baud, voltando para", BAUD_PADRAO);
+        await esperar(ESPERA_VOLTA_PLACA - TIMEOUT_PONG);
+        await this.reabrirPorta(BAUD_PADRAO);
+      } catch (e) {
+        console.warn("[ESPService] Falha ao negociar velocidade:", e);
+        break;
+      }
+    }
+    return this.baudAtual;
+  }
+
+  private iniciarKeepalive() {
+    this.pararKeepalive();
+    this.keepalive = setInterval(() => {
+      if ((this.baudAtual !== BAUD_PADRAO || this.enquadramento === "cobs") && this.writer) {
+        this.enviarMensagem({ type: "PING" }).catch(() => {});
+      }
+    }, INTERVALO_KEEPALIVE);
+  }
+
+  private pararKeepalive() {
+    if (this.keepalive) {
+      clearInterval(this.keepalive);
+      this.keepalive = null;
+    }
   }
 
   /**
    * Loop de leitura da porta serial
    */
   private async lerSerial() {
-    let buffer = "";
+    let buffer = new Uint8Array(0);
 
     while (this.port && this.port.readable && this.reader) {
       try {
@@ -140,29 +375,29 @@ class ESPService {
         }
         if (value) {
           // Acumula no buffer
-          buffer += value;
-
-          // Processa linhas completas
-          const lines = buffer.split("\n");
-
-          // O último elemento é o resto (incompleto) ou vazio
-          buffer = lines.pop() || "";
-
-          for (const line of lines) {
-            const trimmed = line.trim();
-            if (trimmed.startsWith("{") && trimmed.endsWith("}")) {
-              try {
-                const data = JSON.parse(trimmed);
-                console.log("[ESP32 JSON]", data);
-
-                if (this.onTelemetry) {
-                  this.onTelemetry(data);
-                }
-              } catch (e) {
-                // Ignora erro de parse
-              }
+          const junto = new Uint8Array(buffer.length + value.length);
+          junto.set(buffer);
+          junto.set(value, buffer.length);
+          buffer = junto;
+
+          // Processa os quadros completos; o enquadramento pode mudar no meio
+          // (ACK do SET_FORMAT), então o delimitador é procurado a cada quadro
+          let inicio = 0;
+          for (;;) {
+            const fim = buffer.indexOf(this.enquadramento === "cobs" ? 0x00 : 0x0a, inicio);
+            if (fim < 0) break;
+            const quadro = buffer.subarray(inicio, fim);
+            inicio = fim + 1;
+            if (this.enquadramento === "cobs") {
+              this.processarQuadro(quadro);
+            } else {
+              this.processarLinha(decodificador.decode(quadro));
             }
           }
+
+          // O resto é um quadro incompleto; um resto grande demais é lixo
+          buffer = buffer.slice(inicio);
+          if (buffer.length > MAX_QUADRO) buffer = new Uint8Array(0);
         }
       } catch (e) {
         console.error("[ESP32 Error]", e);
@@ -171,38 +406,95 @@ class ESPService {
     }
   }
 
+  private processarLinha(linha: string) {
+    const trimmed = linha.trim();
+    if (trimmed.startsWith("{") && trimmed.endsWith("}")) {
+      try {
+        this.processarMensagem(JSON.parse(trimmed));
+      } catch (e) {
+        // Ignora erro de parse
+      }
+    }
+  }
+
+  // Quadros com CRC errado são descartados sem chegar ao decodificador
+  private processarQuadro(quadro: Uint8Array) {
+    if (quadro.length === 0) return;
+    const conteudo = abrirQuadro(quadro);
+    if (!conteudo) {
+      console.warn("[ESP32] Quadro corrompido descartado");
+      return;
+    }
+    try {
+      this.processarMensagem(
+        this.formato === "msgpack" ? lerMensagem(conteudo) : JSON.parse(decodificador.decode(conteudo)),
+      );
+    } catch (e) {
+      // Ignora erro de parse
+    }
+  }
+
+  private processarMensagem(data: any) {
+    console.log("[ESP32]", data);
+
+    // A placa troca de enquadramento e de formato logo depois deste ACK
+    if (this.ativandoCobs && data.type === "ACK" && data.command === "SET_FORMAT") {
+      this.ativandoCobs = false;
+      this.enquadramento = "cobs";
+      this.formato = "msgpack";
+    }
+
+    if (data.type === "NAK") {
+      this.reenviarPendentes();
+    }
+
+    for (const espera of this.aguardando) {
+      if (espera.filtro(data)) espera.resolver(data);
+    }
+
+    if (this.onTelemetry) {
+      this.onTelemetry(data);
+    }
+  }
+
+  /**
+   * A placa recebeu um quadro corrompido, sem dizer qual: reenvia, na ordem,
+   * todos os comandos ainda sem resposta. Um comando já atendido (só a
+   * resposta ainda não chegou) não é executado de novo: a placa reconhece o
+   * mesmo "seq" e devolve a mesma resposta. Comandos sem "seq" (keepalive,
+   * enviarComando) não são reenviados.
+   */
+  private reenviarPendentes() {
+    for (const pendente of this.pendentes) {
+      if (pendente.reenvios >= MAX_REENVIOS) continue;
+      pendente.reenvios++;
+      this.enviarMensagem(pendente.comando).catch(() => {});
+    }
+  }
+
+  /**
+   * Liga o enquadramento COBS com CRC-16 e o MessagePack nos dois sentidos:
+   * a telemetria passa de ~100 bytes de JSON para ~10. Firmware antigo
+   * responde ERROR (ou nada) e o link continua em linhas de JSON.
+   */
+  async ativarEnquadramento(): Promise<boolean> {
+    this.ativandoCobs = true;
+    const resposta = await this.executar("SET_FORMAT", { format: "msgpack", framing: "cobs" });
+    this.ativandoCobs = false;
+    if (resposta?.type !== "ACK") return false;
+    this.iniciarKeepalive();
+    return true;
+  }
+
   /**
    * Desconecta do ESP32
    */
   async desconectar(): Promise<void> {
     try {
-      // 1. Cancel Reader
-      if (this.reader) {
-        await this.reader.cancel().catch(() => {});
-        this.reader = null;
-      }
+      this.pararKeepalive();
 
-      // 2. Close Writer
-      if (this.writer) {
-        await this.writer.close().catch(() => {});
-        this.writer = null;
-      }
-
-      // 3. Abort pipes
-      if (this.abortController) {
-        this.abortController.abort();
-        this.abortController = null;
-      }
-
-      // 4. Wait for pipes to close
-      if (this.readableStreamClosed) {
-        await this.readableStreamClosed.catch(() => {}); // Ignore errors
-        this.readableStreamClosed = null;
-      }
-      if (this.writableStreamClosed) {
-        await this.writableStreamClosed.catch(() => {}); // Ignore errors
-        this.writableStreamClosed = null;
-      }
+      // 1-4. Streams
+      await this.fecharStreams();
 
       // 5. Close Port
       if (this.port) {
@@ -220,19 +512,48 @@ class ESPService {
    * Envia comando genérico
    */
   async enviarComando(type: string, payload: any = {}): Promise<void> {
-    await this.enviarJSON({ type, ...payload });
+    await this.enviarMensagem({ type, ...payload });
+  }
+
+  /**
+   * Envia um comando com "seq" e espera a resposta com o mesmo "seq" (ACK,
+   * ERROR com "code", ou a mensagem pedida). Vários comandos podem estar em
+   * andamento ao mesmo tempo. Resolve com null se a placa não responder a
+   * tempo (firmware antigo não devolve o "seq").
+   */
+  async executar(type: string, payload: any = {}, timeoutMs = TIMEOUT_RESPOSTA): Promise<any> {
+    const seq = this.proximoSeq;
+    this.proximoSeq = (this.proximoSeq % 0x7fffffff) + 1;
+    const pendente = { comando: { type, ...payload, seq }, reenvios: 0 };
+    this.pendentes.push(pendente);
+    try {
+      return await this.aguardarMensagem(
+        (data) => data.seq === seq,
+        timeoutMs,
+        () => this.enviarMensagem(pendente.comando),
+      );
+    } finally {
+      this.pendentes = this.pendentes.filter((item) => item !== pendente);
+    }
   }
 
   /**
-   * Envia comando JSON para o ESP32
+   * Envia um comando para o ESP32, no formato e enquadramento atuais
    */
-  private async enviarJSON(comando: any): Promise<void> {
+  private async enviarMensagem(comando: any): Promise<void> {
     if (!this.writer) {
       throw new Error("ESP32 não conectado.");
     }
 
-    const json = JSON.stringify(comando) + "\n";
-    await this.writer.write(json);
+    let dados: Uint8Array;
+    if (this.enquadramento === "linhas") {
+      dados = codificador.encode(JSON.stringify(comando) + "\n");
+    } else if (this.formato === "msgpack") {
+      dados = montarQuadro(codificarMsgpack(comando));
+    } else {
+      dados = montarQuadro(codificador.encode(JSON.stringify(comando)));
+    }
+    await this.writer.write(dados);
   }
 
   /**
@@ -244,7 +565,7 @@ class ESPService {
       await this.conectar();
     }
 
-    await this.enviarJSON({
+    await this.enviarMensagem({
       type: "SET_ID",
       userId: userId,
     });
@@ -265,17 +586,60 @@ class ESPService {
 
     const firmwareCommand = mission.practice.firmwareCommand;
 
-    await this.enviarJSON({
+    await this.enviarMensagem({
       type: "SET_MISSION",
       missionId: firmwareCommand,
     });
   }
 
+  /**
+   * Envia o programa da missão CUSTOM (lib/programaMissao.ts) em pedaços,
+   * esperando o ACK de cada um. A placa valida e grava o programa antes de
+   * confirmar o último pedaço; depois basta um SET_MISSION "CUSTOM".
+   */
+  async carregarMissao(programa: Uint8Array): Promise<void> {
+    for (let offset = 0; offset < programa.length; ) {
+      const pedaco = programa.subarray(offset, offset + PEDACO_PROGRAMA);
+      const data = btoa(String.fromCharCode(...pedaco));
+      const resposta = await this.executar("LOAD_MISSION", { offset, size: programa.length, data });
+
+      // Código 4 (ocupado): a placa ainda está trocando o programa anterior
+      if (resposta?.type === "ERROR" && resposta.code === 4) {
+        await esperar(5);
+        continue;
+      }
+      if (resposta?.type !== "ACK") {
+        throw new Error(`Programa recusado: ${resposta?.message ?? "sem resposta"}`);
+      }
+      offset += pedaco.length;
+    }
+  }
+
+  /**
+   * Troca a melodia da Missão 3 (buzzer) por uma em RTTTL, sem regravar o
+   * firmware. Se a missão estiver rodando, a melodia nova começa na hora.
+   */
+  async tocarMelodia(rtttl: string, repetir = true): Promise<void> {
+    for (;;) {
+      const resposta = await this.executar("PLAY", { rtttl, loop: repetir });
+
+      // Código 4 (ocupado): a placa ainda está trocando a melodia anterior
+      if (resposta?.type === "ERROR" && resposta.code === 4) {
+        await esperar(5);
+        continue;
+      }
+      if (resposta?.type !== "ACK") {
+        throw new Error(`Melodia recusada: ${resposta?.message ?? "sem resposta"}`);
+      }
+      return;
+    }
+  }
+
   /**
    * Solicita status/telemetria imediata
    */
   async solicitarStatus(): Promise<void> {
-    await this.enviarJSON({ type: "GET_STATUS" });
+    await this.enviarMensagem({ type: "GET_STATUS" });
   }
 
   /**
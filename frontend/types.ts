@@ -73,15 +73,23 @@ export interface Conquista {
   unlockedAt?: Date;
 }
 
+// Quadro TELEMETRY do firmware (firmware/README.md). A telemetria compacta
+// em MessagePack não traz o userId; potMin, potMax, potMean e tick só vêm
+// com SET_TELEMETRY "extended": true, e seq só na resposta do GET_STATUS.
 export interface TelemetriaESP {
   type: "TELEMETRY";
-  userId: string;
-  deviceId: string;
-  timestamp: number;
+  userId?: string;
+  missionId: string;
   readings: {
-    gpio: Record<string, { mode: string; value: number }>;
-    adc: Record<string, number>;
+    led: number;
+    btn: number;
+    pot: number;
+    potMin?: number;
+    potMax?: number;
+    potMean?: number;
   };
+  tick?: number;
+  seq?: number;
 }
 
 export type StatusConexao = "disconnected" | "connecting" | "connected" | "error";